@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace cata
+{
+
+/**
+ * Appends integers as LEB128 varints and strings with a length prefix to a byte string.
+ * Signed values are zigzag encoded, so small negative numbers stay small too.
+ */
+class binary_writer
+{
+    public:
+        explicit binary_writer( std::string &out ) : out( out ) {}
+
+        void write_varint( uint64_t value ) {
+            while( value >= 0x80 ) {
+                out.push_back( static_cast<char>( ( value & 0x7F ) | 0x80 ) );
+                value >>= 7;
+            }
+            out.push_back( static_cast<char>( value ) );
+        }
+        void write_signed( int64_t value ) {
+            write_varint( ( static_cast<uint64_t>( value ) << 1 ) ^ static_cast<uint64_t>( value >> 63 ) );
+        }
+        void write_string( std::string_view str ) {
+            write_varint( str.size() );
+            out.append( str );
+        }
+        void write_raw( std::string_view bytes ) {
+            out.append( bytes );
+        }
+
+    private:
+        std::string &out;
+};
+
+/** Reads what @ref binary_writer wrote. Throws std::runtime_error when running past the end. */
+class binary_reader
+{
+    public:
+        explicit binary_reader( std::string_view data ) : data( data ) {}
+
+        bool at_end() const {
+            return pos == data.size();
+        }
+        uint64_t read_varint() {
+            uint64_t value = 0;
+            for( int shift = 0; shift < 64; shift += 7 ) {
+                const uint8_t byte = static_cast<uint8_t>( take( 1 )[0] );
+                value |= static_cast<uint64_t>( byte & 0x7F ) << shift;
+                if( !( byte & 0x80 ) ) {
+                    return value;
+                }
+            }
+            throw std::runtime_error( "Malformed varint in binary data" );
+        }
+        int64_t read_signed() {
+            const uint64_t value = read_varint();
+            return static_cast<int64_t>( value >> 1 ) ^ -static_cast<int64_t>( value & 1 );
+        }
+        /** Valid until the underlying data goes away. */
+        std::string_view read_string() {
+            return take( read_varint() );
+        }
+        std::string_view read_raw( size_t size ) {
+            return take( size );
+        }
+
+    private:
+        std::string_view take( size_t size ) {
+            if( size > data.size() - pos ) {
+                throw std::runtime_error( "Unexpected end of binary data" );
+            }
+            std::string_view result = data.substr( pos, size );
+            pos += size;
+            return result;
+        }
+
+        std::string_view data;
+        size_t pos = 0;
+};
+
+} // namespace cata
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+
+namespace cata
+{
+
+/**
+ * 2D grid of booleans packed into a bitset, one bit per tile instead of one byte.
+ * Indexed like a `bool[W][H]` array, i.e. `grid[x][y]`, with the same x-major order.
+ */
+template<size_t W, size_t H>
+class bitset_grid
+{
+    public:
+        using bits_type = std::bitset<W *H>;
+
+        class row_ref
+        {
+            public:
+                row_ref( bits_type &bits, size_t x ) : bits( bits ), offset( x * H ) {}
+                typename bits_type::reference operator[]( size_t y ) {
+                    return bits[offset + y];
+                }
+            private:
+                bits_type &bits;
+                size_t offset;
+        };
+
+        class const_row_ref
+        {
+            public:
+                const_row_ref( const bits_type &bits, size_t x ) : bits( bits ), offset( x * H ) {}
+                bool operator[]( size_t y ) const {
+                    return bits[offset + y];
+                }
+            private:
+                const bits_type &bits;
+                size_t offset;
+        };
+
+        row_ref operator[]( size_t x ) {
+            return row_ref( bits, x );
+        }
+        const_row_ref operator[]( size_t x ) const {
+            return const_row_ref( bits, x );
+        }
+
+        void fill( bool value ) {
+            if( value ) {
+                bits.set();
+            } else {
+                bits.reset();
+            }
+        }
+        bool any() const {
+            return bits.any();
+        }
+        bool operator==( const bitset_grid &rhs ) const {
+            return bits == rhs.bits;
+        }
+
+    private:
+        bits_type bits;
+};
+
+} // namespace cata
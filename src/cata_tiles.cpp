@@ -2699,7 +2699,7 @@ bool cata_tiles::draw_terrain( const tripoint &p, const lit_level ll, int &heigh
         // try drawing memory if invisible and not overridden
         const auto &t = get_terrain_memory_at( p );
 
-        return draw_from_id_string( t.tile, C_TERRAIN, empty_string, p, t.subtile, t.rotation,
+        return draw_from_id_string( t.tile.str(), C_TERRAIN, empty_string, p, t.subtile, t.rotation,
                                     lit_level::MEMORIZED, nv_goggles_activated, height_3d, z_drop );
     }
     return false;
@@ -2718,7 +2718,7 @@ bool cata_tiles::has_terrain_memory_at( const tripoint &p ) const
 {
     if( g->u.should_show_map_memory() ) {
         const memorized_terrain_tile t = g->u.get_memorized_tile( get_map().getabs( p ) );
-        if( t.tile.starts_with( "t_" ) ) {
+        if( t.tile.str().starts_with( "t_" ) ) {
             return true;
         }
     }
@@ -2729,7 +2729,7 @@ bool cata_tiles::has_furniture_memory_at( const tripoint &p ) const
 {
     if( g->u.should_show_map_memory() ) {
         const memorized_terrain_tile t = g->u.get_memorized_tile( get_map().getabs( p ) );
-        if( t.tile.starts_with( "f_" ) ) {
+        if( t.tile.str().starts_with( "f_" ) ) {
             return true;
         }
     }
@@ -2740,7 +2740,7 @@ bool cata_tiles::has_trap_memory_at( const tripoint &p ) const
 {
     if( g->u.should_show_map_memory() ) {
         const memorized_terrain_tile t = g->u.get_memorized_tile( get_map().getabs( p ) );
-        if( t.tile.starts_with( "tr_" ) ) {
+        if( t.tile.str().starts_with( "tr_" ) ) {
             return true;
         }
     }
@@ -2751,7 +2751,7 @@ bool cata_tiles::has_vpart_memory_at( const tripoint &p ) const
 {
     if( g->u.should_show_map_memory() ) {
         const memorized_terrain_tile t = g->u.get_memorized_tile( get_map().getabs( p ) );
-        if( t.tile.starts_with( "vp_" ) ) {
+        if( t.tile.str().starts_with( "vp_" ) ) {
             return true;
         }
     }
@@ -2762,7 +2762,7 @@ memorized_terrain_tile cata_tiles::get_terrain_memory_at( const tripoint &p ) co
 {
     if( g->u.should_show_map_memory() ) {
         const memorized_terrain_tile t = g->u.get_memorized_tile( get_map().getabs( p ) );
-        if( t.tile.starts_with( "t_" ) ) {
+        if( t.tile.str().starts_with( "t_" ) ) {
             return t;
         }
     }
@@ -2773,7 +2773,7 @@ memorized_terrain_tile cata_tiles::get_furniture_memory_at( const tripoint &p )
 {
     if( g->u.should_show_map_memory() ) {
         const memorized_terrain_tile t = g->u.get_memorized_tile( get_map().getabs( p ) );
-        if( t.tile.starts_with( "f_" ) ) {
+        if( t.tile.str().starts_with( "f_" ) ) {
             return t;
         }
     }
@@ -2784,7 +2784,7 @@ memorized_terrain_tile cata_tiles::get_trap_memory_at( const tripoint &p ) const
 {
     if( g->u.should_show_map_memory() ) {
         const memorized_terrain_tile t = g->u.get_memorized_tile( get_map().getabs( p ) );
-        if( t.tile.starts_with( "tr_" ) ) {
+        if( t.tile.str().starts_with( "tr_" ) ) {
             return t;
         }
     }
@@ -2795,7 +2795,7 @@ memorized_terrain_tile cata_tiles::get_vpart_memory_at( const tripoint &p ) cons
 {
     if( g->u.should_show_map_memory() ) {
         const memorized_terrain_tile t = g->u.get_memorized_tile( get_map().getabs( p ) );
-        if( t.tile.starts_with( "vp_" ) ) {
+        if( t.tile.str().starts_with( "vp_" ) ) {
             return t;
         }
     }
@@ -2885,7 +2885,7 @@ bool cata_tiles::draw_furniture( const tripoint &p, const lit_level ll, int &hei
     } else if( invisible[0] && has_furniture_memory_at( p ) ) {
         // try drawing memory if invisible and not overridden
         const auto &t = get_furniture_memory_at( p );
-        return draw_from_id_string( t.tile, C_FURNITURE, empty_string, p, t.subtile, t.rotation,
+        return draw_from_id_string( t.tile.str(), C_FURNITURE, empty_string, p, t.subtile, t.rotation,
                                     lit_level::MEMORIZED, nv_goggles_activated, height_3d, z_drop );
     }
     return false;
@@ -2960,7 +2960,7 @@ bool cata_tiles::draw_trap( const tripoint &p, const lit_level ll, int &height_3
     } else if( invisible[0] && has_trap_memory_at( p ) ) {
         // try drawing memory if invisible and not overridden
         const auto &t = get_trap_memory_at( p );
-        return draw_from_id_string( t.tile, C_TRAP, empty_string, p, t.subtile, t.rotation,
+        return draw_from_id_string( t.tile.str(), C_TRAP, empty_string, p, t.subtile, t.rotation,
                                     lit_level::MEMORIZED, nv_goggles_activated, height_3d, z_drop );
     }
     return false;
@@ -3115,7 +3115,7 @@ bool cata_tiles::draw_vpart( const tripoint &p, lit_level ll, int &height_3d,
     } else if( invisible[0] && has_vpart_memory_at( p ) ) {
         // try drawing memory if invisible and not overridden
         const auto &t = get_vpart_memory_at( p );
-        return draw_from_id_string( t.tile, C_VEHICLE_PART, empty_string, p, t.subtile, t.rotation,
+        return draw_from_id_string( t.tile.str(), C_VEHICLE_PART, empty_string, p, t.subtile, t.rotation,
                                     lit_level::MEMORIZED, nv_goggles_activated, height_3d, z_drop );
     }
     return false;
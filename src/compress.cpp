@@ -3,8 +3,10 @@
 #include <zlib.h>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <stdexcept>
 #include <cstddef>
+#include <cstdint>
 
 void zlib_compress( const std::string &input, std::vector<std::byte> &output )
 {
@@ -50,4 +52,184 @@ void zlib_decompress( const void *compressed_data, int compressed_size, std::str
     } while( result == Z_BUF_ERROR );
 
     output.resize( decompressedSize );
-}
\ No newline at end of file
+}
+// Preset dictionaries, made of snippets of what each kind of data typically looks like.
+// Deflate finds matches closer to the end of the dictionary cheaper, so the most common strings go last.
+// Compressed data can only be read with the exact dictionary it was written with: never edit these,
+// add a new zlib_dictionary instead.
+
+// Map quads: ids are prefixed with their length, item stacks are still JSON.
+// Split after hex escapes so the next character isn't read as part of them.
+static constexpr char map_quad_dictionary_data[] =
+    R"("item_tags":[",)" R"("owner":"your_followers","last_rot_check":,"rot":,"contents":[)"
+    R"("charges":[{"typeid":","bday":,"drop_token":{"turn":,"drop_number":,"parent_number":}},)"
+    R"({"typeid":"}}])"
+    "\x09" "f_bathtub" "\x08" "f_toilet" "\x06" "f_sink" "\x06" "f_oven" "\x08" "f_fridge"
+    "\x0a" "f_bookcase" "\x09" "f_dresser" "\x05" "f_bed" "\x06" "f_sofa" "\x0a" "f_armchair"
+    "\x06" "f_desk" "\x0a" "f_cupboard" "\x06" "f_rack" "\x09" "f_counter" "\x07" "f_chair"
+    "\x07" "f_table"
+    "\x0d" "t_door_locked" "\x0f" "t_concrete_wall" "\x0e" "t_thconc_floor" "\x0c" "t_carpet_red"
+    "\x0f" "t_linoleum_gray" "\x10" "t_linoleum_white" "\x14" "t_window_no_curtains"
+    "\x08" "t_door_o" "\x07" "t_fence" "\x0b" "t_tree_pine" "\x0c" "t_tree_young" "\x06" "t_tree"
+    "\x0c" "t_underbrush" "\x07" "t_shrub" "\x0a" "t_concrete" "\x0c" "t_pavement_y"
+    "\x0a" "t_pavement" "\x0a" "t_sidewalk" "\x0b" "t_flat_roof" "\x0a" "t_open_air"
+    "\x11" "t_window_domestic" "\x08" "t_door_c" "\x08" "t_wall_w" "\x06" "t_wall"
+    "\x0c" "t_grass_tall" "\x0c" "t_grass_long" "\x06" "t_dirt" "\x07" "t_floor" "\x07" "t_grass"
+    // No furniture, traps, radiation, fields or items, then the entities and the next submap's version
+    "\x01\x06" "f_null" "\x01\x00\x90\x01" "\x01\x07" "tr_null" "\x01\x00\x90\x01"
+    "\x01\x00\x90\x01\x00\x00"
+    "\x5b" R"({"cosmetics":[],"spawns":[],"vehicles":[],"partial_constructions":[],"active_furniture":[]})"
+    "\x1c" "BNSM\x01\x1c";
+static constexpr std::string_view map_quad_dictionary( map_quad_dictionary_data,
+        sizeof( map_quad_dictionary_data ) - 1 );
+
+static constexpr std::string_view overmap_dictionary =
+    R"({"layers":[],"region_id":"default","monster_groups":[],"cities":[],"connections_out":{},)"
+    R"("radios":[],"monster_map":[],"tracked_vehicles":[],"scent_traces":[],"npcs":[],"camps":[],)"
+    R"("overmap_special_placements":[],"mapgen_arg_storage":[],"mapgen_arg_index":[],"joins_used":[],)"
+    R"("electric_grid_connections":[],"population":0,"horde":false,"diffuse":false,"dying":false,)"
+    R"("visible":[[[false,180]]],"explored":[[[false,180]]],"notes":[],"extras":[],)"
+    R"(["road_ns",1],["road_ew",1],["house",1],["forest_water",1],["river",1],["river_center",1],)"
+    R"(["lake_shore",1],["lake_surface",1],["lake_water_cube",1],["lake_bed",1],)"
+    R"(["forest_thick",1],["forest",1],["field",1],["empty_rock",32400],["solid_earth",32400],)"
+    R"(["open_air",32400]]},{"layers":[[["open_air",32400]]]})";
+
+// Map memory regions: runs of [tile, subtile, rotation, symbol(, count)] indexing the tile table
+static constexpr std::string_view map_memory_dictionary =
+    R"(],"tile_ids":["vp_seat","vp_frame_vertical","tr_brazier","f_counter","f_bed","f_chair",)"
+    R"("f_table","t_door_c","t_window_domestic","t_sidewalk","t_pavement","t_tree","t_shrub",)"
+    R"("t_grass_long","t_wall","t_floor","t_dirt","t_grass"]})"
+    R"([0,0,0,43],[0,0,0,34],[0,0,0,35],[0,0,0,46],[0,0,0,46,)"
+    R"([1,0,0,0],[2,0,0,0],[3,0,0,0],[4,0,0,0],[5,0,0,0],[1,0,0,0,2],[0,0,0,0,2],[0,0,0,0,3])"
+    R"({"submaps":[null,null,null,null,null,null,null,null,null,null,null,null,null,null,null,null,)"
+    R"([[0,0,0,0,144]],[[0,0,0,0],[1,0,0,0],[0,0,0,0,)";
+
+/**
+ * Dictionary a stream was compressed with, stored in its header.
+ * Values are stored in compressed data, so never change or reuse them.
+ */
+enum class zlib_dictionary : std::uint8_t {
+    none = 0,
+    map_quad = 1,
+    overmap = 2,
+    map_memory = 3,
+};
+
+static zlib_dictionary dictionary_for( compression_kind kind )
+{
+    switch( kind ) {
+        case compression_kind::generic:
+            return zlib_dictionary::none;
+        case compression_kind::map_quad:
+            return zlib_dictionary::map_quad;
+        case compression_kind::overmap:
+            return zlib_dictionary::overmap;
+        case compression_kind::map_memory:
+            return zlib_dictionary::map_memory;
+    }
+    throw std::runtime_error( "Unknown compression kind " + std::to_string(
+                                  static_cast<int>( kind ) ) );
+}
+
+static std::string_view dictionary_contents( zlib_dictionary dictionary )
+{
+    switch( dictionary ) {
+        case zlib_dictionary::none:
+            return {};
+        case zlib_dictionary::map_quad:
+            return map_quad_dictionary;
+        case zlib_dictionary::overmap:
+            return overmap_dictionary;
+        case zlib_dictionary::map_memory:
+            return map_memory_dictionary;
+    }
+    throw std::runtime_error( "Unknown compression dictionary " + std::to_string(
+                                  static_cast<int>( dictionary ) ) );
+}
+
+// Uncompressed size as 4 bytes little endian, then the dictionary
+static constexpr size_t zlib_dict_header_size = 5;
+
+void zlib_dict_compress( const std::string &input, compression_kind kind,
+                         std::vector<std::byte> &output )
+{
+    if( input.size() > UINT32_MAX ) {
+        throw std::runtime_error( "Too much data to compress" );
+    }
+    const zlib_dictionary dictionary_id = dictionary_for( kind );
+    const std::string_view dictionary = dictionary_contents( dictionary_id );
+
+    z_stream stream = {};
+    if( deflateInit( &stream, Z_BEST_SPEED ) != Z_OK ) {
+        throw std::runtime_error( "Zlib compression error" );
+    }
+    if( !dictionary.empty() &&
+        deflateSetDictionary( &stream, reinterpret_cast<const Bytef *>( dictionary.data() ),
+                              dictionary.size() ) != Z_OK ) {
+        deflateEnd( &stream );
+        throw std::runtime_error( "Zlib compression error" );
+    }
+
+    output.resize( zlib_dict_header_size + deflateBound( &stream, input.size() ) );
+    const uint32_t size = input.size();
+    for( size_t i = 0; i < 4; i++ ) {
+        output[i] = static_cast<std::byte>( size >> ( 8 * i ) );
+    }
+    output[4] = static_cast<std::byte>( dictionary_id );
+
+    stream.next_in = reinterpret_cast<Bytef *>( const_cast<char *>( input.data() ) );
+    stream.avail_in = input.size();
+    stream.next_out = reinterpret_cast<Bytef *>( output.data() + zlib_dict_header_size );
+    stream.avail_out = output.size() - zlib_dict_header_size;
+    const int result = deflate( &stream, Z_FINISH );
+    const size_t written = stream.total_out;
+    deflateEnd( &stream );
+    if( result != Z_STREAM_END ) {
+        throw std::runtime_error( "Zlib compression error" );
+    }
+    output.resize( zlib_dict_header_size + written );
+}
+
+void zlib_dict_decompress( const void *compressed_data, size_t compressed_size,
+                           std::string &output )
+{
+    if( compressed_size < zlib_dict_header_size ) {
+        throw std::runtime_error( "Zlib decompression failed: missing header" );
+    }
+    const Bytef *data = static_cast<const Bytef *>( compressed_data );
+    uint32_t size = 0;
+    for( size_t i = 0; i < 4; i++ ) {
+        size |= static_cast<uint32_t>( data[i] ) << ( 8 * i );
+    }
+    const std::string_view dictionary = dictionary_contents( static_cast<zlib_dictionary>( data[4] ) );
+    // Deflate can't expand data by more than 1032:1, preset dictionary or not, so anything claiming
+    // more is damaged and mustn't make us allocate up to 4 GiB
+    if( size > ( compressed_size - zlib_dict_header_size ) * 1032 ) {
+        throw std::runtime_error( "Zlib decompression failed: size doesn't match data" );
+    }
+
+    output.resize( size );
+    z_stream stream = {};
+    if( inflateInit( &stream ) != Z_OK ) {
+        throw std::runtime_error( "Zlib decompression failed" );
+    }
+    stream.next_in = const_cast<Bytef *>( data + zlib_dict_header_size );
+    stream.avail_in = compressed_size - zlib_dict_header_size;
+    stream.next_out = reinterpret_cast<Bytef *>( output.data() );
+    stream.avail_out = size;
+
+    int result = inflate( &stream, Z_FINISH );
+    if( result == Z_NEED_DICT ) {
+        if( inflateSetDictionary( &stream, reinterpret_cast<const Bytef *>( dictionary.data() ),
+                                  dictionary.size() ) != Z_OK ) {
+            inflateEnd( &stream );
+            throw std::runtime_error( "Zlib decompression failed: wrong dictionary" );
+        }
+        result = inflate( &stream, Z_FINISH );
+    }
+    const size_t written = stream.total_out;
+    inflateEnd( &stream );
+    if( result != Z_STREAM_END || written != size ) {
+        throw std::runtime_error( "Zlib decompression failed" );
+    }
+}
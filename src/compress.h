@@ -1,10 +1,36 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "fstream_utils.h"
 
 void zlib_compress( const std::string &input, std::vector<std::byte> &output );
 void zlib_decompress( const void *compressed_data, int compressed_size, std::string &output );
 
+/**
+ * What is being compressed, each kind has its own preset dictionary of the strings it's full of.
+ * Compressed data records the dictionary, not the kind, so a kind can move to a new dictionary
+ * when its save format changes and older saves stay readable.
+ */
+enum class compression_kind : std::uint8_t {
+    generic,
+    map_quad,
+    overmap,
+    map_memory,
+};
 
+/** Name of the dictionary codec, as stored in the `compression` column of save databases. */
+constexpr const char *zlib_dict_codec = "zlib_dict";
+
+/**
+ * Deflate with a preset dictionary for `kind`.
+ * Output starts with a header holding the uncompressed size and the dictionary used,
+ * so decompression needs neither guessing nor the kind.
+ */
+void zlib_dict_compress( const std::string &input, compression_kind kind,
+                         std::vector<std::byte> &output );
+void zlib_dict_decompress( const void *compressed_data, size_t compressed_size,
+                           std::string &output );
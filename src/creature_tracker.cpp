@@ -7,6 +7,8 @@
 #include <utility>
 
 #include "debug.h"
+#include "game_constants.h"
+#include "line.h"
 #include "mongroup.h"
 #include "monster.h"
 #include "mtype.h"
@@ -16,6 +18,18 @@
 
 #define dbg(x) DebugLogFL((x),DC::Game)
 
+static tripoint submap_of( const tripoint &p )
+{
+    return divide_xy_round_to_minus_infinity( p, SEEX );
+}
+
+// Key of the critter in the faction map, friendly monsters are all in the player faction.
+static mfaction_id faction_key( const monster &critter )
+{
+    static const mfaction_str_id playerfaction( "player" );
+    return critter.friendly == 0 ? critter.faction : playerfaction.id();
+}
+
 Creature_tracker::Creature_tracker() = default;
 
 Creature_tracker::~Creature_tracker() = default;
@@ -87,6 +101,7 @@ bool Creature_tracker::add( const shared_ptr_fast<monster> &critter_ptr )
 
     monsters_list.emplace_back( critter_ptr );
     monsters_by_location[critter.pos()] = critter_ptr;
+    add_to_submap_map( critter_ptr );
     add_to_faction_map( critter_ptr );
     return true;
 }
@@ -97,14 +112,125 @@ void Creature_tracker::add_to_faction_map( const shared_ptr_fast<monster> &critt
     monster &critter = *critter_ptr;
 
     // Only 1 faction per mon at the moment.
-    if( critter.friendly == 0 ) {
-        monster_faction_map_[ critter.faction ].insert( critter_ptr );
-    } else {
-        static const mfaction_str_id playerfaction( "player" );
-        monster_faction_map_[ playerfaction ].insert( critter_ptr );
+    monster_faction_map_[ faction_key( critter ) ].insert( critter_ptr );
+}
+
+void Creature_tracker::add_to_submap_map( const shared_ptr_fast<monster> &critter_ptr )
+{
+    monsters_by_submap[submap_of( critter_ptr->pos() )].push_back( critter_ptr );
+}
+
+void Creature_tracker::remove_from_submap_map( const monster &critter )
+{
+    const auto erase_from = [&]( std::vector<shared_ptr_fast<monster>> &bucket ) {
+        const auto iter = std::ranges::find_if( bucket, [&]( const shared_ptr_fast<monster> &ptr ) {
+            return ptr.get() == &critter;
+        } );
+        if( iter == bucket.end() ) {
+            return false;
+        }
+        *iter = std::move( bucket.back() );
+        bucket.pop_back();
+        return true;
+    };
+
+    const auto bucket_iter = monsters_by_submap.find( submap_of( critter.pos() ) );
+    if( bucket_iter != monsters_by_submap.end() && erase_from( bucket_iter->second ) ) {
+        if( bucket_iter->second.empty() ) {
+            monsters_by_submap.erase( bucket_iter );
+        }
+        return;
+    }
+
+    // Same as for the location map, it might be filed under another submap.
+    for( auto iter = monsters_by_submap.begin(); iter != monsters_by_submap.end(); ++iter ) {
+        if( erase_from( iter->second ) ) {
+            if( iter->second.empty() ) {
+                monsters_by_submap.erase( iter );
+            }
+            return;
+        }
+    }
+}
+
+void Creature_tracker::find_in_box( const tripoint &min, const tripoint &max,
+                                    const std::function<bool( const monster & )> &pred,
+                                    std::vector<shared_ptr_fast<monster>> &result ) const
+{
+    const tripoint sm_min = submap_of( min );
+    const tripoint sm_max = submap_of( max );
+    const auto check_bucket = [&]( const std::vector<shared_ptr_fast<monster>> &bucket ) {
+        for( const shared_ptr_fast<monster> &mon_ptr : bucket ) {
+            const tripoint &p = mon_ptr->pos();
+            if( !mon_ptr->is_dead() && p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y &&
+                p.z >= min.z && p.z <= max.z && pred( *mon_ptr ) ) {
+                result.push_back( mon_ptr );
+            }
+        }
+    };
+
+    const int z_min = std::max( sm_min.z, -OVERMAP_DEPTH );
+    const int z_max = std::min( sm_max.z, OVERMAP_HEIGHT );
+    if( z_max < z_min ) {
+        return;
+    }
+    const size_t box_submaps = static_cast<size_t>( sm_max.x - sm_min.x + 1 ) *
+                               ( sm_max.y - sm_min.y + 1 ) * ( z_max - z_min + 1 );
+    if( monsters_by_submap.size() < box_submaps ) {
+        // Fewer occupied submaps than there are in the box, cheaper to go through all of them.
+        for( const auto &bucket : monsters_by_submap ) {
+            const tripoint &sm = bucket.first;
+            if( sm.x >= sm_min.x && sm.x <= sm_max.x && sm.y >= sm_min.y && sm.y <= sm_max.y &&
+                sm.z >= z_min && sm.z <= z_max ) {
+                check_bucket( bucket.second );
+            }
+        }
+        return;
+    }
+    for( int z = z_min; z <= z_max; z++ ) {
+        for( int x = sm_min.x; x <= sm_max.x; x++ ) {
+            for( int y = sm_min.y; y <= sm_max.y; y++ ) {
+                const auto iter = monsters_by_submap.find( tripoint( x, y, z ) );
+                if( iter != monsters_by_submap.end() ) {
+                    check_bucket( iter->second );
+                }
+            }
+        }
     }
 }
 
+std::vector<shared_ptr_fast<monster>> Creature_tracker::find_in_radius( const tripoint &center,
+                                   const int radius ) const
+{
+    std::vector<shared_ptr_fast<monster>> result;
+    const tripoint offset( radius, radius, radius );
+    find_in_box( center - offset, center + offset, [&]( const monster & critter ) {
+        return rl_dist( center, critter.pos() ) <= radius;
+    }, result );
+    return result;
+}
+
+std::vector<shared_ptr_fast<monster>> Creature_tracker::find_in_radius( const tripoint &center,
+                                   const int radius, const mfaction_id &faction ) const
+{
+    std::vector<shared_ptr_fast<monster>> result;
+    const tripoint offset( radius, radius, radius );
+    find_in_box( center - offset, center + offset, [&]( const monster & critter ) {
+        return faction_key( critter ) == faction && rl_dist( center, critter.pos() ) <= radius;
+    }, result );
+    return result;
+}
+
+std::vector<shared_ptr_fast<monster>> Creature_tracker::find_in_rectangle( const tripoint &min,
+                                   const tripoint &max ) const
+{
+    std::vector<shared_ptr_fast<monster>> result;
+    find_in_box( min, max, []( const monster & ) {
+        return true;
+    }, result );
+    return result;
+}
+
 void Creature_tracker::update_faction( const monster &critter )
 {
     // find critter in monsters_list and obtain shared_ptr
@@ -166,6 +292,10 @@ bool Creature_tracker::update_pos( const monster &critter, const tripoint &new_p
     if( iter != monsters_list.end() ) {
         monsters_by_location.erase( critter.pos() );
         monsters_by_location[new_pos] = *iter;
+        if( submap_of( critter.pos() ) != submap_of( new_pos ) ) {
+            remove_from_submap_map( critter );
+            monsters_by_submap[submap_of( new_pos )].push_back( *iter );
+        }
         return true;
     } else {
         const tripoint &old_pos = critter.pos();
@@ -182,6 +312,8 @@ bool Creature_tracker::update_pos( const monster &critter, const tripoint &new_p
 
 void Creature_tracker::remove_from_location_map( const monster &critter )
 {
+    remove_from_submap_map( critter );
+
     const auto pos_iter = monsters_by_location.find( critter.pos() );
     if( pos_iter != monsters_by_location.end() && pos_iter->second.get() == &critter ) {
         monsters_by_location.erase( pos_iter );
@@ -228,6 +360,7 @@ void Creature_tracker::clear()
 {
     monsters_list.clear();
     monsters_by_location.clear();
+    monsters_by_submap.clear();
     monster_faction_map_.clear();
     removed_.clear();
 }
@@ -235,9 +368,11 @@ void Creature_tracker::clear()
 void Creature_tracker::rebuild_cache()
 {
     monsters_by_location.clear();
+    monsters_by_submap.clear();
     monster_faction_map_.clear();
     for( const shared_ptr_fast<monster> &mon_ptr : monsters_list ) {
         monsters_by_location[mon_ptr->pos()] = mon_ptr;
+        add_to_submap_map( mon_ptr );
         add_to_faction_map( mon_ptr );
     }
 }
@@ -257,12 +392,14 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
     if( first_iter != monsters_by_location.end() ) {
         first_ptr = first_iter->second;
         monsters_by_location.erase( first_iter );
+        remove_from_submap_map( *first_ptr );
     }
 
     shared_ptr_fast<monster> second_ptr;
     if( second_iter != monsters_by_location.end() ) {
         second_ptr = second_iter->second;
         monsters_by_location.erase( second_iter );
+        remove_from_submap_map( *second_ptr );
     }
     // implied: (first_ptr != second_ptr) or (first_ptr == nullptr && second_ptr == nullptr)
 
@@ -273,9 +410,11 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
     // If the pointers have been taken out of the list, put them back in.
     if( first_ptr ) {
         monsters_by_location[first.pos()] = first_ptr;
+        add_to_submap_map( first_ptr );
     }
     if( second_ptr ) {
         monsters_by_location[second.pos()] = second_ptr;
+        add_to_submap_map( second_ptr );
     }
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <functional>
 #include <memory>
 #include <set>
 #include <unordered_map>
@@ -80,6 +81,18 @@ class Creature_tracker
         /** Removes dead monsters from. Their pointers are invalidated. */
         void remove_dead();
 
+        /**
+         * Returns the living monsters within `radius` (as in @ref rl_dist) of `center`, in no particular order.
+         * Only the submaps around `center` are looked at, not every monster.
+         */
+        std::vector<shared_ptr_fast<monster>> find_in_radius( const tripoint &center, int radius ) const;
+        /** Same as above, but only monsters that belong to `faction` in @ref factions. */
+        std::vector<shared_ptr_fast<monster>> find_in_radius( const tripoint &center, int radius,
+                                           const mfaction_id &faction ) const;
+        /** Returns the living monsters inside the box from `min` to `max` (inclusive), in no particular order. */
+        std::vector<shared_ptr_fast<monster>> find_in_rectangle( const tripoint &min,
+                                           const tripoint &max ) const;
+
         const std::vector<shared_ptr_fast<monster>> &get_monsters_list() const {
             return monsters_list;
         }
@@ -94,8 +107,16 @@ class Creature_tracker
     private:
         std::vector<shared_ptr_fast<monster>> monsters_list;
         std::unordered_map<tripoint, shared_ptr_fast<monster>> monsters_by_location;
-        /** Remove the monsters entry in @ref monsters_by_location */
+        /** Monsters grouped by the submap they are on, for finding the ones near a point. */
+        std::unordered_map<tripoint, std::vector<shared_ptr_fast<monster>>> monsters_by_submap;
+        /** Remove the monsters entries in @ref monsters_by_location and @ref monsters_by_submap */
         void remove_from_location_map( const monster &critter );
+        void add_to_submap_map( const shared_ptr_fast<monster> &critter );
+        void remove_from_submap_map( const monster &critter );
+        /** Appends the living monsters inside the box that `pred` accepts to `result`. */
+        void find_in_box( const tripoint &min, const tripoint &max,
+                          const std::function<bool( const monster & )> &pred,
+                          std::vector<shared_ptr_fast<monster>> &result ) const;
 };
 
 
@@ -208,6 +208,28 @@ capture_debugmsg::~capture_debugmsg()
     capturing = false;
 }
 
+/** Where debugmsg calls on this thread go instead of being reported, if anywhere. */
+static thread_local std::vector<deferred_debugmsg> *collected_debugmsgs = nullptr;
+
+std::vector<deferred_debugmsg> collect_debugmsgs_during( const std::function<void()> &func )
+{
+    std::vector<deferred_debugmsg> messages;
+    std::vector<deferred_debugmsg> *const previous = collected_debugmsgs;
+    collected_debugmsgs = &messages;
+    on_out_of_scope restore( [previous]() {
+        collected_debugmsgs = previous;
+    } );
+    func();
+    return messages;
+}
+
+void replay_debugmsgs( const std::vector<deferred_debugmsg> &messages )
+{
+    for( const deferred_debugmsg &msg : messages ) {
+        realDebugmsg( msg.filename, msg.line, msg.funcname, msg.level, msg.text );
+    }
+}
+
 bool debug_has_error_been_observed()
 {
     return error_observed;
@@ -462,6 +484,11 @@ void realDebugmsg( const char *filename, const char *line, const char *funcname,
     assert( line != nullptr );
     assert( funcname != nullptr );
 
+    if( collected_debugmsgs ) {
+        collected_debugmsgs->push_back( { filename, line, funcname, debug_level, text } );
+        return;
+    }
+
     if( capturing ) {
         captured += text;
     } else {
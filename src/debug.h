@@ -50,6 +50,7 @@
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 #include <functional>
 
 #include "string_formatter.h"
@@ -207,6 +208,29 @@ void debug_reset_ignored_messages();
  */
 std::string capture_debugmsg_during( const std::function<void()> &func );
 
+/**
+ * A debugmsg call held back by @ref collect_debugmsgs_during.
+ * The location strings come from the debugmsg macros and have static storage, the
+ * repetition folding of realDebugmsg compares them by address.
+ */
+struct deferred_debugmsg {
+    const char *filename;
+    const char *line;
+    const char *funcname;
+    DL level;
+    std::string text;
+};
+
+/**
+ * Hold back debugmsg calls made on the calling thread during func execution,
+ * so work done on other threads can report them later, in a stable order.
+ * @return the held back calls, to be passed to @ref replay_debugmsgs
+ */
+std::vector<deferred_debugmsg> collect_debugmsgs_during( const std::function<void()> &func );
+
+/** Report held back debugmsg calls as if they were made now. */
+void replay_debugmsgs( const std::vector<deferred_debugmsg> &messages );
+
 /**
  * Should be called after catacurses::stdscr is initialized.
  * If catacurses::stdscr is available, shows all buffered debugmsg prompts.
@@ -161,8 +161,16 @@ std::string read_entire_file( const std::string &path )
     if( !infile.is_open() ) {
         return "";
     }
-    std::string ret = std::string( std::istreambuf_iterator<char>( *infile ),
-                                   std::istreambuf_iterator<char>() );
+    // Size the string up front instead of growing it one character at a time
+    std::istream &in = *infile;
+    in.seekg( 0, std::istream::end );
+    const std::streamoff size = in.tellg();
+    in.seekg( 0, std::istream::beg );
+    std::string ret;
+    if( size > 0 ) {
+        ret.resize( static_cast<size_t>( size ) );
+        in.read( ret.data(), size );
+    }
     if( infile.fail() ) {
         return "";
     }
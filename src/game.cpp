@@ -1606,8 +1606,8 @@ bool game::do_turn()
     // reset player noise
     u.volume = 0;
 
-    // Finally, clear pathfinding cache
-    Pathfinding::clear_d_maps();
+    // Finally, drop pathfinding maps that can't be reused next turn
+    Pathfinding::retire_d_maps();
 
     return false;
 }
@@ -2759,6 +2759,11 @@ bool game::save( bool quitting )
         return false;
     }
 
+    // The last save was reported as done before its background writes were
+    if( !world->wait_for_pending_writes() ) {
+        popup( _( "Failed to write the save from %s to disk." ), to_string( last_save_turn ) );
+    }
+
     world->start_save_tx();
 
     cata::run_on_game_save_hooks( *DynamicDataLoader::get_instance().lua );
@@ -2782,12 +2787,21 @@ bool game::save( bool quitting )
             world_generator->active_world->info->add_save( save_t::from_save_id( u.get_save_id() ) );
 
             auto duration = world->commit_save_tx();
+            last_save_turn = calendar::turn;
+            if( quitting && !world->wait_for_pending_writes() ) {
+                popup( _( "Failed to save the maps" ) );
+                return false;
+            }
             add_msg( m_info, _( "World Saved (took %dms)." ), duration );
             return true;
         }
     } catch( std::ios::failure &err ) {
         popup( _( "Failed to save game data" ) );
         return false;
+    } catch( const std::runtime_error & ) {
+        // Database writes that aren't deferred to the background fail this way
+        popup( _( "Failed to save game data" ) );
+        return false;
     }
 }
 
@@ -10773,6 +10787,48 @@ void game::vertical_notes( int z_before, int z_after )
     }
 }
 
+// Which way the map is likely to shift next, if at all
+static point prefetch_heading( const map &m, const avatar &u )
+{
+    // Vehicles can cross a submap in a turn or two, so look ahead as soon as they move
+    if( u.in_vehicle ) {
+        if( const optional_vpart_position vp = m.veh_at( u.pos() ) ) {
+            const vehicle &veh = vp->vehicle();
+            if( veh.velocity != 0 ) {
+                const units::angle dir = veh.velocity > 0 ? veh.move.dir() :
+                                         veh.move.dir() + units::from_degrees( 180 );
+                return point( std::lround( units::cos( dir ) ), std::lround( units::sin( dir ) ) );
+            }
+        }
+    }
+    // On foot, once in the outer quarter of the centre submap, crossing which shifts the map
+    const point in_centre = u.pos().xy() - point( HALF_MAPSIZE_X, HALF_MAPSIZE_Y );
+    point heading;
+    if( in_centre.x < SEEX / 4 ) {
+        heading.x = -1;
+    } else if( in_centre.x >= SEEX - SEEX / 4 ) {
+        heading.x = 1;
+    }
+    if( in_centre.y < SEEY / 4 ) {
+        heading.y = -1;
+    } else if( in_centre.y >= SEEY - SEEY / 4 ) {
+        heading.y = 1;
+    }
+    return heading;
+}
+
+static void prefetch_submaps_ahead( const map &m, const avatar &u )
+{
+    if( get_option<bool>( "MAP_PREFETCH" ) ) {
+        const point heading = prefetch_heading( m, u );
+        if( get_option<bool>( "MAP_PREGENERATE" ) ) {
+            // One overmap terrain per turn keeps up with walking and spreads out the cost
+            m.pregenerate_submaps( heading, 1 );
+        }
+        m.prefetch_submaps( heading );
+    }
+}
+
 point game::update_map( player &p )
 {
     point p2( p.posx(), p.posy() );
@@ -10807,6 +10863,7 @@ point game::update_map( int &x, int &y )
         // We need this call because even if the map hasn't shifted we may have changed z-level and can now see farther
         // TODO: only make this call if we changed z-level
         update_overmap_seen();
+        prefetch_submaps_ahead( m, u );
         // Not actually shifting the submaps, all the stuff below would do nothing
         return point_zero;
     }
@@ -10868,9 +10925,20 @@ point game::update_map( int &x, int &y )
     // This call will generate new monsters in addition to loading, so it's placed after NPC loading
     m.spawn_monsters( false ); // Static monsters
 
+    // Submaps outside the map that shifted out are cold now
+    const int map_memory_budget = get_option<int>( "MAP_MEMORY_BUDGET" );
+    if( map_memory_budget > 0 ) {
+        const tripoint abs_sub = m.get_abs_sub();
+        MAPBUFFER.evict_cold_submaps( static_cast<size_t>( map_memory_budget ) * 1024 * 1024,
+                                      inclusive_cuboid<tripoint>( tripoint( abs_sub.xy(), -OVERMAP_DEPTH ),
+                                              tripoint( abs_sub.xy() + point( MAPSIZE - 1, MAPSIZE - 1 ), OVERMAP_HEIGHT ) ) );
+    }
+
     // Update what parts of the world map we can see
     update_overmap_seen();
 
+    prefetch_submaps_ahead( m, u );
+
     return shift;
 }
 
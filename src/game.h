@@ -1019,6 +1019,8 @@ class game
         std::set<character_id> follower_ids; // Keep track of follower NPC IDs
         int moves_since_last_save = 0;
         time_t last_save_timestamp;
+        /** In-game time of the last save, which may still be written to disk in the background. */
+        time_point last_save_turn;
         mutable std::array<float, OVERMAP_LAYERS> latest_lightlevels;
         // remoteveh() cache
         time_point remoteveh_cache_time;
@@ -2,6 +2,9 @@
 
 #include <algorithm>
 #include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <set>
 #include <unordered_map>
 #include <vector>
@@ -150,12 +153,73 @@ class generic_factory
         // TEMPORARY until 0.G: Remove "ident" support
         const std::string legacy_id_member_name = "ident";
 
+        /**
+         * Flat copy of `map` built by finalize and used for lookups until the version changes.
+         * Open addressing with linear probing at a load factor of at most one half, so a lookup
+         * is a multiplication and a scan of a few adjacent slots instead of a walk through
+         * the nodes of a bucket, and never allocates.
+         */
+        struct id_slot {
+            string_id<T> id;
+            int cid = INVALID_CID;
+        };
+        std::vector<id_slot> id_table;
+        int id_table_bits = 1;
+        size_t id_table_max_probe = 0;
+        int64_t id_table_version = INVALID_VERSION;
+
+        size_t id_table_home( const string_id<T> &id ) const {
+            // Fibonacci hashing, hashes of interned ids are consecutive numbers which need spreading
+            const uint64_t hash = std::hash<string_id<T>>()( id );
+            return static_cast<size_t>( ( hash * 0x9E3779B97F4A7C15ULL ) >> ( 64 - id_table_bits ) );
+        }
+
+        void build_id_table() {
+            id_table_bits = 1;
+            while( ( size_t( 1 ) << id_table_bits ) < map.size() * 2 ) {
+                id_table_bits++;
+            }
+            const size_t mask = ( size_t( 1 ) << id_table_bits ) - 1;
+            id_table.assign( mask + 1, id_slot() );
+            id_table_max_probe = 0;
+            for( const auto &elem : map ) {
+                size_t slot = id_table_home( elem.first );
+                size_t probe = 0;
+                while( id_table[slot].cid != INVALID_CID ) {
+                    slot = ( slot + 1 ) & mask;
+                    probe++;
+                }
+                id_table[slot] = { elem.first, elem.second.to_i() };
+                id_table_max_probe = std::max( id_table_max_probe, probe );
+            }
+            id_table_version = version;
+        }
+
         bool find_id( const string_id<T> &id, int_id<T> &result ) const {
             if( id._version == version ) {
                 result = int_id<T>( id._cid );
                 return is_valid( result );
             }
 
+            if( id_table_version == version ) {
+                const size_t mask = id_table.size() - 1;
+                size_t slot = id_table_home( id );
+                for( size_t probe = 0; probe <= id_table_max_probe; probe++ ) {
+                    const id_slot &entry = id_table[slot];
+                    if( entry.cid == INVALID_CID ) {
+                        break;
+                    }
+                    if( entry.id == id ) {
+                        result = int_id<T>( entry.cid );
+                        id.set_cid_version( entry.cid, version );
+                        return true;
+                    }
+                    slot = ( slot + 1 ) & mask;
+                }
+                id.set_cid_version( INVALID_CID, version );
+                return false;
+            }
+
             const auto iter = map.find( id );
             // map lookup happens at most once per string_id instance per generic_factory::version
             // id was not found, explicitly marking it as "invalid"
@@ -173,6 +237,7 @@ class generic_factory
             if( !find_id( id, i_id ) ) {
                 return;
             }
+            id_table_version = INVALID_VERSION;
             auto iter = map.begin();
             const auto end = map.end();
             for( ; iter != end; ) {
@@ -385,6 +450,7 @@ class generic_factory
             for( size_t i = 0; i < list.size(); i++ ) {
                 list[i].id.set_cid_version( static_cast<int>( i ), version );
             }
+            build_id_table();
             set_finalized( true );
         }
 
@@ -417,6 +483,7 @@ class generic_factory
             inc_version();
             list.clear();
             map.clear();
+            id_table.clear();
             abstracts.clear();
             deferred.clear();
         }
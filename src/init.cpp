@@ -1,14 +1,19 @@
 #include "init.h"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <fstream>
+#include <future>
 #include <iterator>
 #include <memory>
 #include <sstream> // for throwing errors
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "achievement.h"
@@ -19,6 +24,7 @@
 #include "ascii_art.h"
 #include "artifact.h"
 #include "behavior.h"
+#include "binary_io.h"
 #include "bionics.h"
 #include "bodypart.h"
 #include "catalua.h"
@@ -46,6 +52,7 @@
 #include "flag.h"
 #include "flag_trait.h"
 #include "gates.h"
+#include "get_version.h"
 #include "harvest.h"
 #include "item_action.h"
 #include "item_category.h"
@@ -74,12 +81,14 @@
 #include "npc.h"
 #include "npc_class.h"
 #include "omdata.h"
+#include "options.h"
 #include "overlay_ordering.h"
 #include "overmap.h"
 #include "overmapbuffer.h"
 #include "overmap_connection.h"
 #include "overmap_location.h"
 #include "overmap_special.h"
+#include "path_info.h"
 #include "profession.h"
 #include "recipe_dictionary.h"
 #include "recipe_groups.h"
@@ -96,6 +105,7 @@
 #include "start_location.h"
 #include "string_formatter.h"
 #include "text_snippets.h"
+#include "thread_pool.h"
 #include "translations.h"
 #include "trap.h"
 #include "type_id.h"
@@ -111,9 +121,138 @@
 #endif
 
 struct DynamicDataLoader::cached_streams {
-    lru_cache<std::string, shared_ptr_fast<std::istringstream>> cache;
+    lru_cache<std::string, shared_ptr_fast<const std::string>> cache;
 };
 
+namespace
+{
+
+/** A data file read and indexed on the thread pool, waiting for its objects to be loaded. */
+struct indexed_data_file {
+    std::string path;
+    std::string contents;
+    uint64_t hash = 0;
+    // Declared after the data they point into, so they go away first
+    std::unique_ptr<JsonIn> jsin;
+    std::vector<JsonObject> objects;
+};
+
+constexpr uint64_t fnv_offset_basis = 0xcbf29ce484222325ULL;
+
+/** FNV-1a, good enough to notice any change to the data. */
+uint64_t hash_bytes( uint64_t hash, std::string_view data )
+{
+    for( const char c : data ) {
+        hash ^= static_cast<unsigned char>( c );
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+uint64_t hash_combine( uint64_t hash, uint64_t value )
+{
+    return ( hash ^ value ) * 0x100000001b3ULL;
+}
+
+/** Positions of the members of every top level object, without looking at their values. */
+std::vector<JsonObject> index_objects( JsonIn &jsin )
+{
+    std::vector<JsonObject> objects;
+    // TEMPORARY until 0.G: Remove single object support for consistency
+    if( jsin.test_object() ) {
+        objects.push_back( jsin.get_object() );
+        // if there's anything else in the file, it's an error.
+        jsin.eat_whitespace();
+        if( jsin.good() ) {
+            jsin.error( string_format( "expected single-object file but found '%c'", jsin.peek() ) );
+        }
+    } else if( jsin.test_array() ) {
+        jsin.start_array();
+        while( !jsin.end_array() ) {
+            objects.push_back( jsin.get_object() );
+        }
+    } else {
+        // not an object or an array?
+        jsin.error( "expected object or array" );
+    }
+    return objects;
+}
+
+std::unique_ptr<indexed_data_file> index_data_file( const std::string &path )
+{
+    std::unique_ptr<indexed_data_file> file = std::make_unique<indexed_data_file>();
+    file->path = path;
+    file->contents = read_entire_file( path );
+    file->hash = hash_bytes( fnv_offset_basis, file->contents );
+    file->jsin = std::make_unique<JsonIn>( file->contents, path );
+    file->objects = index_objects( *file->jsin );
+    return file;
+}
+
+/**
+ * Whether `version` names exactly the code that was built, so what passed the checks with it is
+ * worth remembering. Not the case for the fallbacks of builds without git, nor for builds with
+ * uncommitted changes, which may change the checks without changing the version.
+ */
+bool is_exact_version( std::string_view version )
+{
+    return !version.empty() && version != "0.1" && version != "unstable" &&
+           !version.ends_with( "-dirty" );
+}
+
+constexpr std::string_view verified_data_magic = "BNVD";
+constexpr uint64_t verified_data_version = 1;
+/** How many combinations of data (e.g. mod lists) are remembered. */
+constexpr size_t max_verified_data = 8;
+
+/** Hashes of data that passed the consistency checks before, most recent first. */
+std::vector<uint64_t> read_verified_data()
+{
+    std::vector<uint64_t> hashes;
+    const std::string data = read_entire_file( PATH_INFO::verified_data() );
+    if( !data.starts_with( verified_data_magic ) ) {
+        return hashes;
+    }
+    try {
+        cata::binary_reader in( data );
+        in.read_raw( verified_data_magic.size() );
+        if( in.read_varint() != verified_data_version ) {
+            return hashes;
+        }
+        const uint64_t count = in.read_varint();
+        for( uint64_t i = 0; i < count && i < max_verified_data; i++ ) {
+            hashes.push_back( in.read_varint() );
+        }
+    } catch( const std::runtime_error & ) {
+        // Broken file, the data just gets checked again
+        hashes.clear();
+    }
+    return hashes;
+}
+
+void write_verified_data( uint64_t hash )
+{
+    std::vector<uint64_t> hashes = read_verified_data();
+    std::erase( hashes, hash );
+    hashes.insert( hashes.begin(), hash );
+    if( hashes.size() > max_verified_data ) {
+        hashes.resize( max_verified_data );
+    }
+    std::string data;
+    cata::binary_writer out( data );
+    out.write_raw( verified_data_magic );
+    out.write_varint( verified_data_version );
+    out.write_varint( hashes.size() );
+    for( const uint64_t h : hashes ) {
+        out.write_varint( h );
+    }
+    write_to_file( PATH_INFO::verified_data(), [&]( std::ostream & fout ) {
+        fout.write( data.data(), data.size() );
+    }, nullptr );
+}
+
+} // namespace
+
 DynamicDataLoader::DynamicDataLoader()
 {
     initialize();
@@ -139,18 +278,13 @@ void DynamicDataLoader::load_object( const JsonObject &jo, const std::string &sr
     it->second( jo, src, base_path, full_path );
 }
 
-shared_ptr_fast<std::istream> DynamicDataLoader::get_cached_stream( const std::string &path )
+shared_ptr_fast<const std::string> DynamicDataLoader::get_cached_file( const std::string &path )
 {
     assert( !finalized && "Cannot open data file after finalization." );
     assert( stream_cache && "Stream cache is only available during finalization" );
-    shared_ptr_fast<std::istringstream> cached = stream_cache->cache.get( path, nullptr );
-    // Create a new stream if the file is not opened yet, or if some code is still
-    // using the previous stream (in such case, `cached` and `stream_cache` have
-    // two references to the stream, hence the test for > 2).
+    shared_ptr_fast<const std::string> cached = stream_cache->cache.get( path, nullptr );
     if( !cached ) {
-        cached = make_shared_fast<std::istringstream>( read_entire_file( path ) );
-    } else if( cached.use_count() > 2 ) {
-        cached = make_shared_fast<std::istringstream>( cached->str() );
+        cached = make_shared_fast<const std::string>( read_entire_file( path ) );
     }
     stream_cache->cache.insert( 8, path, cached );
     return cached;
@@ -167,8 +301,8 @@ void DynamicDataLoader::load_deferred( deferred_json &data )
                 debugmsg( "JSON source location has null path, data may load incorrectly" );
             } else {
                 try {
-                    shared_ptr_fast<std::istream> stream = get_cached_stream( *it->first.path );
-                    JsonIn jsin( *stream, it->first );
+                    shared_ptr_fast<const std::string> contents = get_cached_file( *it->first.path );
+                    JsonIn jsin( *contents, it->first );
                     JsonObject jo = jsin.get_object();
                     load_object( jo, it->second );
                 } catch( const JsonError &err ) {
@@ -467,7 +601,7 @@ void DynamicDataLoader::initialize()
 }
 
 void DynamicDataLoader::load_data_from_path( const std::string &path, const std::string &src,
-        loading_ui &ui )
+        loading_ui & )
 {
     assert( !finalized && "Can't load additional data after finalization.  Must be unloaded first." );
     // We assume that each folder is consistent in itself,
@@ -486,60 +620,79 @@ void DynamicDataLoader::load_data_from_path( const std::string &path, const std:
             files.push_back( path );
         }
     }
-    // iterate over each file
-    for( auto &files_i : files ) {
-        const std::string &file = files_i;
-        // open the file as a stream
-        cata_ifstream infile = std::move( cata_ifstream().mode( cata_ios_mode::binary ).open( file ) );
-        // and stuff it into ram
-        std::istringstream iss(
-            std::string(
-                ( std::istreambuf_iterator<char>( *infile ) ),
-                std::istreambuf_iterator<char>()
-            )
-        );
+    data_hash = hash_bytes( hash_combine( data_hash, files.size() ), src );
+    try {
+        init::load_data_files( files, [&]( const std::string & file, uint64_t hash,
+        std::vector<JsonObject> &objects ) {
+            data_hash = hash_combine( hash_bytes( data_hash, file ), hash );
+            dispatch_objects( objects, src, path, file );
+        } );
+    } catch( const JsonError &err ) {
+        throw std::runtime_error( err.what() );
+    }
+}
+
+void init::load_data_files( const std::vector<std::string> &files,
+                            const std::function<void( const std::string &, uint64_t, std::vector<JsonObject> & )> &load )
+{
+    // Reading and indexing the files doesn't depend on any loaded data, so it's done on the
+    // thread pool. The objects are loaded here, one file after another in the original order.
+    std::vector<std::future<std::unique_ptr<indexed_data_file>>> indexed;
+    indexed.reserve( files.size() );
+    for( const std::string &file : files ) {
+        indexed.push_back( get_thread_pool().submit( [file]() {
+            return index_data_file( file );
+        } ) );
+    }
+    // After an error nobody is going to look at the rest of the objects, which must not
+    // complain about that, least of all from a worker thread
+    const auto discard = []( indexed_data_file & data ) {
+        for( const JsonObject &jo : data.objects ) {
+            jo.allow_omitted_members();
+        }
+    };
+    for( auto next = indexed.begin(); next != indexed.end(); ++next ) {
+        std::unique_ptr<indexed_data_file> data;
         try {
-            // parse it
-            JsonIn jsin( iss, file );
-            load_all_from_json( jsin, src, ui, path, file );
-        } catch( const JsonError &err ) {
-            throw std::runtime_error( err.what() );
+            data = next->get();
+            load( data->path, data->hash, data->objects );
+        } catch( ... ) {
+            if( data ) {
+                discard( *data );
+            }
+            for( auto rest = std::next( next ); rest != indexed.end(); ++rest ) {
+                try {
+                    discard( *rest->get() );
+                } catch( ... ) {
+                    // Only the first error is reported
+                }
+            }
+            throw;
         }
     }
 }
 
-void DynamicDataLoader::load_all_from_json( JsonIn &jsin, const std::string &src, loading_ui &,
+void DynamicDataLoader::dispatch_objects( std::vector<JsonObject> &objects, const std::string &src,
         const std::string &base_path, const std::string &full_path )
 {
-    // TEMPORARY until 0.G: Remove single object support for consistency
-    if( jsin.test_object() ) {
-        // find type and dispatch single object
-        JsonObject jo = jsin.get_object();
+    for( JsonObject &jo : objects ) {
         load_object( jo, src, base_path, full_path );
         jo.finish();
-        // if there's anything else in the file, it's an error.
-        jsin.eat_whitespace();
-        if( jsin.good() ) {
-            jsin.error( string_format( "expected single-object file but found '%c'", jsin.peek() ) );
-        }
-    } else if( jsin.test_array() ) {
-        jsin.start_array();
-        // find type and dispatch each object until array close
-        while( !jsin.end_array() ) {
-            JsonObject jo = jsin.get_object();
-            load_object( jo, src, base_path, full_path );
-            jo.finish();
-        }
-    } else {
-        // not an object or an array?
-        jsin.error( "expected object or array" );
     }
     inp_mngr.pump_events();
 }
 
+void DynamicDataLoader::load_all_from_json( JsonIn &jsin, const std::string &src, loading_ui &,
+        const std::string &base_path, const std::string &full_path )
+{
+    std::vector<JsonObject> objects = index_objects( jsin );
+    dispatch_objects( objects, src, base_path, full_path );
+}
+
 void DynamicDataLoader::unload_data()
 {
     finalized = false;
+    data_hash = fnv_offset_basis;
 
     //Moved to the top as a temp hack until vehicles are made into game objects
     vehicle_prototype::reset();
@@ -728,8 +881,21 @@ void DynamicDataLoader::finalize_loaded_data( loading_ui &ui )
     }
 }
 
-void DynamicDataLoader::check_consistency( loading_ui &ui )
+void DynamicDataLoader::check_consistency( loading_ui &ui, bool may_skip )
 {
+    // The same data checked by the same build gives the same results
+    const uint64_t verified_hash = hash_bytes( data_hash, getVersionString() );
+    const bool use_verified_data = may_skip && get_option<bool>( "SKIP_VERIFIED_DATA_CHECKS" ) &&
+                                   is_exact_version( getVersionString() );
+    if( use_verified_data ) {
+        const std::vector<uint64_t> verified = read_verified_data();
+        if( std::find( verified.begin(), verified.end(), verified_hash ) != verified.end() ) {
+            DebugLog( DL::Info, DC::Main ) << "Data is unchanged since it was last verified, skipping checks";
+            finalized = true;
+            return;
+        }
+    }
+
     ui.new_context( _( "Verifying" ) );
 
     using named_entry = std::pair<std::string, std::function<void()>>;
@@ -817,11 +983,34 @@ void DynamicDataLoader::check_consistency( loading_ui &ui )
     }
 
     ui.show();
+    // Checkers can't run on the thread pool: looking up ids and translating names writes
+    // to caches shared by all of them, and some of them create temporary items.
+    // Only data that checks out clean may skip the checks next time
+    bool clean = true;
     for( const named_entry &e : entries ) {
-        e.second();
+        const auto start = std::chrono::steady_clock::now();
+        std::exception_ptr error;
+        const std::vector<deferred_debugmsg> messages = collect_debugmsgs_during( [&]() {
+            try {
+                e.second();
+            } catch( ... ) {
+                error = std::current_exception();
+            }
+        } );
+        replay_debugmsgs( messages );
+        if( error ) {
+            std::rethrow_exception( error );
+        }
+        clean = clean && messages.empty();
+        DebugLog( DL::Info, DC::Main ) << "Checked " << e.first << " in "
+                                       << std::chrono::duration_cast<std::chrono::milliseconds>
+                                       ( std::chrono::steady_clock::now() - start ).count() << " ms";
         ui.proceed();
     }
 
+    if( use_verified_data && clean ) {
+        write_verified_data( verified_hash );
+    }
     finalized = true;
 }
 
@@ -899,7 +1088,11 @@ static void load_and_finalize_packs( loading_ui &ui, const std::string &msg,
         }
     }
 
-    loader.check_consistency( ui );
+    // Lua scripts can change the data without it showing up in the hash of the JSON files
+    const bool has_lua_mods = std::any_of( available.begin(), available.end(), []( const mod_id & mod ) {
+        return mod->lua_api_version.has_value();
+    } );
+    loader.check_consistency( ui, !has_lua_mods );
 
     if( cata::has_lua() ) {
         init::load_main_lua_scripts( *loader.lua, packs );
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <list>
 #include <map>
@@ -71,6 +72,8 @@ class DynamicDataLoader
 
     private:
         bool finalized = false;
+        /** Hash of the contents of all loaded data files and the order they were loaded in. */
+        uint64_t data_hash = 0xcbf29ce484222325ULL;
 
         struct cached_streams;
         std::unique_ptr<cached_streams> stream_cache;
@@ -97,6 +100,12 @@ class DynamicDataLoader
          */
         void load_all_from_json( JsonIn &jsin, const std::string &src, loading_ui &ui,
                                  const std::string &base_path, const std::string &full_path );
+        /**
+         * Load the already indexed top level objects of one file, in order.
+         * @throws std::exception on all kind of errors.
+         */
+        void dispatch_objects( std::vector<JsonObject> &objects, const std::string &src,
+                               const std::string &base_path, const std::string &full_path );
         /**
          * Load a single object from a json object.
          * @param jo The json object to load the C++-object from.
@@ -119,8 +128,10 @@ class DynamicDataLoader
          * Check the consistency of all the loaded data.
          * May print a debugmsg if something seems wrong.
          * @param ui Finalization status display.
+         * @param may_skip Whether the checks can be skipped when the same data passed them
+         * before, see the SKIP_VERIFIED_DATA_CHECKS option.
          */
-        void check_consistency( loading_ui &ui );
+        void check_consistency( loading_ui &ui, bool may_skip = false );
 
         /**
          * Returns the single instance of this class.
@@ -169,12 +180,11 @@ class DynamicDataLoader
         }
 
         /**
-         * Get a possibly cached stream for deferred data loading. If the cached
-         * stream is still in use by outside code, this returns a new stream to
-         * avoid conflict of stream cursor. The stream cursor is not reset if a
-         * cached stream is returned.
+         * Get the possibly cached contents of a data file for deferred data loading.
+         * The contents are never modified, so they can be parsed by several
+         * JsonIn at once.
          */
-        shared_ptr_fast<std::istream> get_cached_stream( const std::string &path );
+        shared_ptr_fast<const std::string> get_cached_file( const std::string &path );
 };
 
 namespace init
@@ -186,6 +196,16 @@ void load_main_lua_scripts( cata::lua_state &state, const std::vector<mod_id> &p
 /** Returns whether the game data is currently loaded. */
 bool is_data_loaded();
 
+/**
+ * Read the top level objects of data files on the thread pool and hand them to load
+ * along with a hash of the file contents, one file after another in the given order.
+ * If anything throws, the files still being read are waited for and their objects
+ * discarded before the exception is passed on.
+ */
+void load_data_files( const std::vector<std::string> &files,
+                      const std::function<void( const std::string &path, uint64_t hash, std::vector<JsonObject> &objects )>
+                      &load );
+
 /**
  * Load & finalize modlist that consists of single vanilla BN core "mod".
  * @throw std::exception if the loaded data is not valid.
@@ -811,35 +811,35 @@ void add_array_to_set( std::set<std::string> &s, const JsonObject &json, const s
 
 int JsonIn::tell()
 {
-    return stream->tellg();
+    return stream.tellg();
 }
 char JsonIn::peek()
 {
-    return static_cast<char>( stream->peek() );
+    return static_cast<char>( stream.peek() );
 }
 bool JsonIn::good()
 {
-    return stream->good();
+    return stream.good();
 }
 
 void JsonIn::seek( int pos )
 {
-    stream->clear();
-    stream->seekg( pos );
+    stream.clear();
+    stream.seekg( pos );
     ate_separator = false;
 }
 
 void JsonIn::eat_whitespace()
 {
     while( is_whitespace( peek() ) ) {
-        stream->get();
+        stream.get();
     }
 }
 
 void JsonIn::uneat_whitespace()
 {
     while( tell() > 0 ) {
-        stream->seekg( -1, std::istream::cur );
+        stream.seekg( -1, std::istream::cur );
         if( !is_whitespace( peek() ) ) {
             break;
         }
@@ -867,7 +867,7 @@ void JsonIn::skip_separator()
         if( ate_separator ) {
             error( "duplicate comma" );
         }
-        stream->get();
+        stream.get();
         ate_separator = true;
     } else if( ch == ']' || ch == '}' || ch == ':' ) {
         // okay
@@ -896,7 +896,7 @@ void JsonIn::skip_pair_separator()
 {
     char ch;
     eat_whitespace();
-    stream->get( ch );
+    stream.get( ch );
     if( ch != ':' ) {
         std::stringstream err;
         err << "expected pair separator ':', not '" << ch << "'";
@@ -911,16 +911,16 @@ void JsonIn::skip_string()
 {
     char ch;
     eat_whitespace();
-    stream->get( ch );
+    stream.get( ch );
     if( ch != '"' ) {
         std::stringstream err;
         err << "expecting string but found '" << ch << "'";
         error( err.str(), -1 );
     }
-    while( stream->good() ) {
-        stream->get( ch );
+    while( stream.good() ) {
+        stream.get( ch );
         if( ch == '\\' ) {
-            stream->get( ch );
+            stream.get( ch );
             continue;
         } else if( ch == '"' ) {
             break;
@@ -985,7 +985,7 @@ void JsonIn::skip_true()
 {
     char text[5];
     eat_whitespace();
-    stream->get( text, 5 );
+    stream.get( text, 5 );
     if( strcmp( text, "true" ) != 0 ) {
         std::stringstream err;
         err << R"(expected "true", but found ")" << text << "\"";
@@ -998,7 +998,7 @@ void JsonIn::skip_false()
 {
     char text[6];
     eat_whitespace();
-    stream->get( text, 6 );
+    stream.get( text, 6 );
     if( strcmp( text, "false" ) != 0 ) {
         std::stringstream err;
         err << R"(expected "false", but found ")" << text << "\"";
@@ -1011,7 +1011,7 @@ void JsonIn::skip_null()
 {
     char text[5];
     eat_whitespace();
-    stream->get( text, 5 );
+    stream.get( text, 5 );
     if( strcmp( text, "null" ) != 0 ) {
         std::stringstream err;
         err << R"(expected "null", but found ")" << text << "\"";
@@ -1025,11 +1025,11 @@ void JsonIn::skip_number()
     char ch;
     eat_whitespace();
     // skip all of (+-0123456789.eE)
-    while( stream->good() ) {
-        stream->get( ch );
+    while( stream.good() ) {
+        stream.get( ch );
         if( ch != '+' && ch != '-' && ( ch < '0' || ch > '9' ) &&
             ch != 'e' && ch != 'E' && ch != '.' ) {
-            stream->unget();
+            stream.unget();
             break;
         }
     }
@@ -1043,7 +1043,7 @@ std::string JsonIn::get_member_name()
     return s;
 }
 
-static bool get_escaped_or_unicode( std::istream &stream, std::string &s, std::string &err )
+static bool get_escaped_or_unicode( json_char_source &stream, std::string &s, std::string &err )
 {
     if( !stream.good() ) {
         err = "stream not good";
@@ -1186,8 +1186,8 @@ std::string JsonIn::get_string()
     bool success = false;
     do {
         // the first character had better be a '"'
-        stream->get( ch );
-        if( !stream->good() ) {
+        stream.get( ch );
+        if( !stream.good() ) {
             err = "read operation failed";
             break;
         }
@@ -1197,28 +1197,28 @@ std::string JsonIn::get_string()
         }
         // add chars to the string, one at a time
         do {
-            ch = stream->peek();
-            if( !stream->good() ) {
+            ch = stream.peek();
+            if( !stream.good() ) {
                 err = "read operation failed";
                 break;
             }
             if( ch == '"' ) {
-                stream->ignore();
+                stream.ignore();
                 success = true;
                 break;
             }
-            if( !get_escaped_or_unicode( *stream, s, err ) ) {
+            if( !get_escaped_or_unicode( stream, s, err ) ) {
                 break;
             }
-        } while( stream->good() );
+        } while( stream.good() );
     } while( false );
     if( success ) {
         end_value();
         return s;
     }
-    if( stream->eof() ) {
+    if( stream.eof() ) {
         error( "couldn't find end of string, reached EOF." );
-    } else if( stream->fail() ) {
+    } else if( stream.fail() ) {
         error( "stream failure while reading string." );
     } else {
         error( err, -1 );
@@ -1358,11 +1358,11 @@ number_sci_notation JsonIn::get_any_number()
     number_sci_notation ret;
     int mod_e = 0;
     eat_whitespace();
-    if( !stream->get( ch ) ) {
+    if( !stream.get( ch ) ) {
         error( "unexpected end of input", 0 );
     }
     if( ( ret.negative = ch == '-' ) ) {
-        if( !stream->get( ch ) ) {
+        if( !stream.get( ch ) ) {
             error( "unexpected end of input", 0 );
         }
     } else if( ch != '.' && ( ch < '0' || ch > '9' ) ) {
@@ -1373,7 +1373,7 @@ number_sci_notation JsonIn::get_any_number()
     }
     if( ch == '0' ) {
         // allow a single leading zero in front of a '.' or 'e'/'E'
-        stream->get( ch );
+        stream.get( ch );
         if( ch >= '0' && ch <= '9' ) {
             error( "leading zeros not allowed", -1 );
         }
@@ -1381,31 +1381,31 @@ number_sci_notation JsonIn::get_any_number()
     while( ch >= '0' && ch <= '9' ) {
         ret.number *= 10;
         ret.number += ( ch - '0' );
-        if( !stream->get( ch ) ) {
+        if( !stream.get( ch ) ) {
             break;
         }
     }
     if( ch == '.' ) {
-        while( stream->get( ch ) && ch >= '0' && ch <= '9' ) {
+        while( stream.get( ch ) && ch >= '0' && ch <= '9' ) {
             ret.number *= 10;
             ret.number += ( ch - '0' );
             mod_e -= 1;
         }
     }
-    if( stream && ( ch == 'e' || ch == 'E' ) ) {
-        if( !stream->get( ch ) ) {
+    if( ch == 'e' || ch == 'E' ) {
+        if( !stream.get( ch ) ) {
             error( "unexpected end of input", 0 );
         }
         bool neg;
         if( ( neg = ch == '-' ) || ch == '+' ) {
-            if( !stream->get( ch ) ) {
+            if( !stream.get( ch ) ) {
                 error( "unexpected end of input", 0 );
             }
         }
         while( ch >= '0' && ch <= '9' ) {
             ret.exp *= 10;
             ret.exp += ( ch - '0' );
-            if( !stream->get( ch ) ) {
+            if( !stream.get( ch ) ) {
                 break;
             }
         }
@@ -1414,9 +1414,7 @@ number_sci_notation JsonIn::get_any_number()
         }
     }
     // unget the final non-number character (probably a separator)
-    if( stream ) {
-        stream->unget();
-    }
+    stream.unget();
     end_value();
     ret.exp += mod_e;
     return ret;
@@ -1428,9 +1426,9 @@ bool JsonIn::get_bool()
     char text[5];
     std::stringstream err;
     eat_whitespace();
-    stream->get( ch );
+    stream.get( ch );
     if( ch == 't' ) {
-        stream->get( text, 4 );
+        stream.get( text, 4 );
         if( strcmp( text, "rue" ) == 0 ) {
             end_value();
             return true;
@@ -1440,7 +1438,7 @@ bool JsonIn::get_bool()
             error( err.str(), -4 );
         }
     } else if( ch == 'f' ) {
-        stream->get( text, 5 );
+        stream.get( text, 5 );
         if( strcmp( text, "alse" ) == 0 ) {
             end_value();
             return false;
@@ -1468,7 +1466,7 @@ void JsonIn::start_array()
 {
     eat_whitespace();
     if( peek() == '[' ) {
-        stream->get();
+        stream.get();
         ate_separator = false;
         return;
     } else {
@@ -1488,7 +1486,7 @@ bool JsonIn::end_array()
             uneat_whitespace();
             error( "comma not allowed at end of array" );
         }
-        stream->get();
+        stream.get();
         end_value();
         return true;
     } else {
@@ -1501,7 +1499,7 @@ void JsonIn::start_object()
 {
     eat_whitespace();
     if( peek() == '{' ) {
-        stream->get();
+        stream.get();
         ate_separator = false; // not that we want to
         return;
     } else {
@@ -1521,7 +1519,7 @@ bool JsonIn::end_object()
             uneat_whitespace();
             error( "comma not allowed at end of object" );
         }
-        stream->get();
+        stream.get();
         end_value();
         return true;
     } else {
@@ -1582,7 +1580,7 @@ bool JsonIn::read_null( bool throw_on_error )
         return error_or_false( throw_on_error, "Expected null" );
     }
     char text[5];
-    if( !stream->get( text, 5 ) ) {
+    if( !stream.get( text, 5 ) ) {
         error( "Unexpected end of stream reading null", 0 );
     }
     if( 0 != strcmp( text, "null" ) ) {
@@ -1838,14 +1836,14 @@ std::string JsonIn::line_number( int offset_modifier )
 {
     const std::string &name = escape_property( path ? normalize_relative_path( *path )
                               : "<unknown source file>" );
-    if( stream && stream->eof() ) {
+    if( stream.eof() ) {
         switch( error_log_format ) {
             case error_log_format_t::human_readable:
                 return name + ":EOF";
             case error_log_format_t::github_action:
                 return "file=" + name + ",line=EOF";
         }
-    } else if( !stream || stream->fail() ) {
+    } else if( stream.fail() ) {
         switch( error_log_format ) {
             case error_log_format_t::human_readable:
                 return name + ":???";
@@ -1859,15 +1857,15 @@ std::string JsonIn::line_number( int offset_modifier )
     char ch;
     seek( 0 );
     for( int i = 0; i < pos + offset_modifier; ++i ) {
-        stream->get( ch );
-        if( !stream->good() ) {
+        stream.get( ch );
+        if( !stream.good() ) {
             break;
         }
         if( ch == '\r' ) {
             offset = 1;
             ++line;
             if( peek() == '\n' ) {
-                stream->get();
+                stream.get();
                 ++i;
             }
         } else if( ch == '\n' ) {
@@ -1903,25 +1901,25 @@ void JsonIn::error( const std::string &message, int offset )
             break;
     }
     // if we can't get more info from the stream don't try
-    if( !stream->good() ) {
+    if( !stream.good() ) {
         throw JsonError( err_header.str() + escape_data( message ) );
     }
     // Seek to eof after throwing to avoid continue reading from the incorrect
     // location. The calling code of json error methods is supposed to restore
     // the stream location if it wishes to recover from the error.
     on_out_of_scope seek_to_eof( [this]() {
-        stream->seekg( 0, std::istream::end );
+        stream.seekg( 0, std::istream::end );
     } );
     std::ostringstream err;
     err << message;
     // also print surrounding few lines of context, if not too large
     err << "\n\n";
-    stream->seekg( offset, std::istream::cur );
+    stream.seekg( offset, std::istream::cur );
     size_t pos = tell();
     rewind( 3, 240 );
     size_t startpos = tell();
     std::string buffer( pos - startpos, '\0' );
-    stream->read( buffer.data(), pos - startpos );
+    stream.read( buffer.data(), pos - startpos );
     auto it = buffer.begin();
     for( ; it < buffer.end() && ( *it == '\r' || *it == '\n' ); ++it ) {
         // skip starting newlines
@@ -1949,30 +1947,30 @@ void JsonIn::error( const std::string &message, int offset )
     err << "^\n";
     seek( pos );
     // if that wasn't the end of the line, continue underneath pointer
-    char ch = stream->get();
+    char ch = stream.get();
     if( ch == '\r' ) {
         if( peek() == '\n' ) {
-            stream->get();
+            stream.get();
         }
     } else if( ch == '\n' ) {
         // pass
-    } else if( peek() != '\r' && peek() != '\n' && !stream->eof() ) {
+    } else if( peek() != '\r' && peek() != '\n' && !stream.eof() ) {
         for( size_t i = 0; i < pos - startpos + 1; ++i ) {
             err << ' ';
         }
     }
     // print the next couple lines as well
     int line_count = 0;
-    for( int i = 0; line_count < 3 && stream->good() && i < 240; ++i ) {
-        stream->get( ch );
-        if( !stream->good() ) {
+    for( int i = 0; line_count < 3 && stream.good() && i < 240; ++i ) {
+        stream.get( ch );
+        if( !stream.good() ) {
             break;
         }
         if( ch == '\r' ) {
             ch = '\n';
             ++line_count;
-            if( stream->peek() == '\n' ) {
-                stream->get( ch );
+            if( stream.peek() == '\n' ) {
+                stream.get( ch );
             }
         } else if( ch == '\n' ) {
             ++line_count;
@@ -1990,11 +1988,11 @@ void JsonIn::string_error( const std::string &message, const int offset )
 {
     if( test_string() ) {
         // skip quote mark
-        stream->ignore();
+        stream.ignore();
         std::string s;
         std::string err;
         for( int i = 0; i < offset; ++i ) {
-            if( !get_escaped_or_unicode( *stream, s, err ) ) {
+            if( !get_escaped_or_unicode( stream, s, err ) ) {
                 break;
             }
         }
@@ -2021,15 +2019,15 @@ void JsonIn::rewind( int max_lines, int max_chars )
         return;
     }
     int lines_found = 0;
-    stream->seekg( -1, std::istream::cur );
+    stream.seekg( -1, std::istream::cur );
     for( int i = 0; i < max_chars; ++i ) {
         size_t tellpos = tell();
         if( peek() == '\n' ) {
             ++lines_found;
             if( tellpos > 0 ) {
-                stream->seekg( -1, std::istream::cur );
+                stream.seekg( -1, std::istream::cur );
                 if( peek() != '\r' ) {
-                    stream->seekg( 1, std::istream::cur );
+                    stream.seekg( 1, std::istream::cur );
                 } else {
                     --tellpos;
                 }
@@ -2040,18 +2038,18 @@ void JsonIn::rewind( int max_lines, int max_chars )
         if( lines_found == max_lines ) {
             // don't include the last \n or \r
             if( peek() == '\n' ) {
-                stream->seekg( 1, std::istream::cur );
+                stream.seekg( 1, std::istream::cur );
             } else if( peek() == '\r' ) {
-                stream->seekg( 1, std::istream::cur );
+                stream.seekg( 1, std::istream::cur );
                 if( peek() == '\n' ) {
-                    stream->seekg( 1, std::istream::cur );
+                    stream.seekg( 1, std::istream::cur );
                 }
             }
             break;
         } else if( tellpos == 0 ) {
             break;
         }
-        stream->seekg( -1, std::istream::cur );
+        stream.seekg( -1, std::istream::cur );
     }
 }
 
@@ -2059,13 +2057,13 @@ std::string JsonIn::substr( size_t pos, size_t len )
 {
     std::string ret;
     if( len == std::string::npos ) {
-        stream->seekg( 0, std::istream::end );
+        stream.seekg( 0, std::istream::end );
         size_t end = tell();
         len = end - pos;
     }
     ret.resize( len );
-    stream->seekg( pos );
-    stream->read( ret.data(), len );
+    stream.seekg( pos );
+    stream.read( ret.data(), len );
     return ret;
 }
 
@@ -1,14 +1,17 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <bitset>
 #include <cstddef>
+#include <cstdio>
 #include <cstdint>
 #include <iostream>
 #include <map>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -86,8 +89,10 @@ struct number_sci_notation {
 /* JsonIn
  * ======
  *
- * The JsonIn class provides a wrapper around a std::istream,
- * with methods for reading JSON data directly from the stream.
+ * The JsonIn class provides a wrapper around a std::istream or an in-memory buffer,
+ * with methods for reading JSON data directly from it.
+ * Parsing from a buffer is considerably faster, prefer it when the whole input
+ * is available anyway (e.g. files that are read completely).
  *
  * JsonObject and JsonArray provide higher-level wrappers,
  * and are a little easier to use in most cases,
@@ -163,10 +168,179 @@ struct number_sci_notation {
  * If an if;else if;... is missing the "else", it /will/ cause bugs,
  * so preindexing as a JsonObject is safer, as well as tidier.
  */
+/**
+ * Characters for @ref JsonIn, read either from a std::istream or directly from a contiguous
+ * buffer. Mirrors the part of the std::istream interface used by the parser, including the
+ * state flags, so both behave the same. The buffer case needs no virtual calls or stream
+ * sentries per character and never copies the data.
+ */
+class json_char_source
+{
+    public:
+        explicit json_char_source( std::istream &s ) : stream( &s ) {}
+        explicit json_char_source( std::string_view data ) : data( data ) {}
+
+        bool good() const {
+            return stream ? stream->good() : !eof_bit && !fail_bit;
+        }
+        bool eof() const {
+            return stream ? stream->eof() : eof_bit;
+        }
+        bool fail() const {
+            return stream ? stream->fail() : fail_bit;
+        }
+        void clear() {
+            if( stream ) {
+                stream->clear();
+            } else {
+                eof_bit = false;
+                fail_bit = false;
+            }
+        }
+
+        int peek() {
+            if( stream ) {
+                return stream->peek();
+            }
+            if( !good() ) {
+                fail_bit = true;
+                return EOF;
+            }
+            if( pos >= data.size() ) {
+                eof_bit = true;
+                return EOF;
+            }
+            return static_cast<unsigned char>( data[pos] );
+        }
+        int get() {
+            if( stream ) {
+                return stream->get();
+            }
+            if( !good() ) {
+                fail_bit = true;
+                return EOF;
+            }
+            if( pos >= data.size() ) {
+                eof_bit = true;
+                fail_bit = true;
+                return EOF;
+            }
+            return static_cast<unsigned char>( data[pos++] );
+        }
+        bool get( char &ch ) {
+            if( stream ) {
+                return static_cast<bool>( stream->get( ch ) );
+            }
+            const int c = get();
+            if( c == EOF ) {
+                return false;
+            }
+            ch = static_cast<char>( c );
+            return true;
+        }
+        /** Up to `count - 1` characters until the end of the line, always null terminated. */
+        bool get( char *s, int count ) {
+            if( stream ) {
+                return static_cast<bool>( stream->get( s, count ) );
+            }
+            int i = 0;
+            if( good() ) {
+                while( i + 1 < count && pos < data.size() && data[pos] != '\n' ) {
+                    s[i++] = data[pos++];
+                }
+                eof_bit = pos >= data.size();
+            }
+            s[i] = '\0';
+            if( i == 0 ) {
+                fail_bit = true;
+            }
+            return !fail_bit;
+        }
+        void unget() {
+            if( stream ) {
+                stream->unget();
+                return;
+            }
+            eof_bit = false;
+            if( fail_bit ) {
+                return;
+            }
+            if( pos == 0 ) {
+                fail_bit = true;
+            } else {
+                pos--;
+            }
+        }
+        void ignore() {
+            if( stream ) {
+                stream->ignore();
+            } else if( !good() ) {
+                fail_bit = true;
+            } else if( pos >= data.size() ) {
+                eof_bit = true;
+            } else {
+                pos++;
+            }
+        }
+        void read( char *s, int count ) {
+            if( stream ) {
+                stream->read( s, count );
+                return;
+            }
+            if( !good() ) {
+                fail_bit = true;
+                return;
+            }
+            const size_t n = std::min( static_cast<size_t>( count ), data.size() - pos );
+            data.copy( s, n, pos );
+            pos += n;
+            if( n < static_cast<size_t>( count ) ) {
+                eof_bit = true;
+                fail_bit = true;
+            }
+        }
+
+        int tellg() {
+            if( stream ) {
+                return static_cast<int>( stream->tellg() );
+            }
+            if( !good() ) {
+                fail_bit = true;
+                return -1;
+            }
+            return static_cast<int>( pos );
+        }
+        void seekg( int offset, std::ios_base::seekdir dir = std::ios_base::beg ) {
+            if( stream ) {
+                stream->seekg( offset, dir );
+                return;
+            }
+            eof_bit = false;
+            if( fail_bit ) {
+                return;
+            }
+            const long long base = dir == std::ios_base::cur ? pos :
+                                   dir == std::ios_base::end ? data.size() : 0;
+            const long long target = base + offset;
+            if( target < 0 || target > static_cast<long long>( data.size() ) ) {
+                fail_bit = true;
+            } else {
+                pos = static_cast<size_t>( target );
+            }
+        }
+
+    private:
+        std::istream *stream = nullptr;
+        std::string_view data;
+        size_t pos = 0;
+        bool eof_bit = false;
+        bool fail_bit = false;
+};
+
 class JsonIn
 {
     private:
-        std::istream *stream;
+        json_char_source stream;
         shared_ptr_fast<std::string> path;
         bool ate_separator = false;
 
@@ -175,11 +349,19 @@ class JsonIn
         void end_value();
 
     public:
-        JsonIn( std::istream &s ) : stream( &s ) {}
+        JsonIn( std::istream &s ) : stream( s ) {}
         JsonIn( std::istream &s, const std::string &path )
-            : stream( &s ), path( make_shared_fast<std::string>( path ) ) {}
+            : stream( s ), path( make_shared_fast<std::string>( path ) ) {}
         JsonIn( std::istream &s, const json_source_location &loc )
-            : stream( &s ), path( loc.path ) {
+            : stream( s ), path( loc.path ) {
+            seek( loc.offset );
+        }
+        /** Parses straight from `data`, which has to outlive this. Offsets are relative to its start. */
+        explicit JsonIn( std::string_view data ) : stream( data ) {}
+        JsonIn( std::string_view data, const std::string &path )
+            : stream( data ), path( make_shared_fast<std::string>( path ) ) {}
+        JsonIn( std::string_view data, const json_source_location &loc )
+            : stream( data ), path( loc.path ) {
             seek( loc.offset );
         }
         JsonIn( const JsonIn & ) = delete;
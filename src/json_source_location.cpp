@@ -8,14 +8,12 @@ void throw_error_at_json_loc( const json_source_location &loc, const std::string
     if( !loc.path ) {
         throw JsonError( string_format( "Json error: (unknown pos): %s", message ) );
     }
-    shared_ptr_fast<std::istream> stream = DynamicDataLoader::get_instance().get_cached_stream(
-            *loc.path );
-    if( !stream ) {
+    shared_ptr_fast<const std::string> contents = DynamicDataLoader::get_instance().get_cached_file(
+                *loc.path );
+    if( !contents ) {
         throw JsonError( string_format( "Json error: (%s:%d): %s", *loc.path, loc.offset, message ) );
     }
-    // Pass a new location with offset 0 so JsonIn stream would begin from the beginning of the file
-    // and not from some old cached position.
-    JsonIn jsin( *stream, json_source_location{ loc.path, 0 } );
+    JsonIn jsin( *contents, json_source_location{ loc.path, 0 } );
     jsin.error( message, loc.offset );
 }
 
@@ -2,6 +2,7 @@
 #include "shadowcasting.h" // IWYU pragma: associated
 
 #include <algorithm>
+#include <bitset>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
@@ -102,6 +103,16 @@ void map::add_light_from_items( const tripoint &p, const item_stack::iterator &b
     }
 }
 
+void map::update_weather_transparency_lookup()
+{
+    const float sight_penalty = get_weather().weather_id->sight_penalty;
+
+    if( sight_penalty != 1.0f &&
+        LIGHT_TRANSPARENCY_OPEN_AIR * sight_penalty != weather_transparency_lookup.transparency ) {
+        weather_transparency_lookup.reset( LIGHT_TRANSPARENCY_OPEN_AIR * sight_penalty );
+    }
+}
+
 // TODO: Consider making this just clear the cache and dynamically fill it in as is_transparent() is called
 bool map::build_transparency_cache( const int zlev )
 {
@@ -126,15 +137,12 @@ bool map::build_transparency_cache( const int zlev )
 
     const float sight_penalty = get_weather().weather_id->sight_penalty;
 
-    if( sight_penalty != 1.0f &&
-        LIGHT_TRANSPARENCY_OPEN_AIR * sight_penalty != weather_transparency_lookup.transparency ) {
-        weather_transparency_lookup.reset( LIGHT_TRANSPARENCY_OPEN_AIR * sight_penalty );
-    }
+    update_weather_transparency_lookup();
 
     // Traverse the submaps in order
     for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
         for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
-            const auto cur_submap = get_submap_at_grid( {smx, smy, zlev} );
+            const submap *const cur_submap = get_submap_at_grid( {smx, smy, zlev} );
 
             const point sm_offset = sm_to_ms_copy( point( smx, smy ) );
 
@@ -198,6 +206,7 @@ bool map::build_transparency_cache( const int zlev )
             }
         }
     }
+    map_cache.buffered_light_dirty |= map_cache.transparency_cache_dirty;
     map_cache.transparency_cache_dirty.reset();
     return true;
 }
@@ -482,7 +491,7 @@ void map::generate_lightmap( const int zlev )
     // Traverse the submaps in order
     for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
         for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
-            const auto cur_submap = get_submap_at_grid( { smx, smy, zlev } );
+            const submap *const cur_submap = get_submap_at_grid( { smx, smy, zlev } );
 
             for( int sx = 0; sx < SEEX; ++sx ) {
                 for( int sy = 0; sy < SEEY; ++sy ) {
@@ -525,7 +534,7 @@ void map::generate_lightmap( const int zlev )
                         add_light_source( p, furniture->light_emitted );
                     }
 
-                    for( auto &fld : cur_submap->get_field( { sx, sy } ) ) {
+                    for( const auto &fld : cur_submap->get_field( { sx, sy } ) ) {
                         const field_entry *cur = &fld.second;
                         const int light_emitted = cur->light_emitted();
                         if( light_emitted > 0 ) {
@@ -636,18 +645,201 @@ void map::generate_lightmap( const int zlev )
         unbuffered: (12^2)*(160*4) = apply_light_ray x 92160
         buffered:   (12*4)*(160)   = apply_light_ray x 7680
     */
-    const tripoint cache_start( 0, 0, zlev );
-    const tripoint cache_end( LIGHTMAP_CACHE_X, LIGHTMAP_CACHE_Y, zlev );
-    for( const tripoint &p : points_in_rectangle( cache_start, cache_end ) ) {
-        if( light_source_buffer[p.x][p.y] > 0.0 ) {
-            apply_light_source( p, light_source_buffer[p.x][p.y] );
-        }
-    }
+    apply_buffered_light_sources( zlev );
     for( const std::pair<tripoint, float> &elem : lm_override ) {
         lm[elem.first.x][elem.first.y].fill( elem.second );
     }
 }
 
+// Upper bound on how far light of `luminance` gets on a level where no tile is more transparent
+//   than `min_transparency`. See apply_light_source and light_check.
+static int buffered_light_radius( float luminance, const float min_transparency )
+{
+    if( luminance <= lit_level::LOW ) {
+        return 0;
+    } else if( luminance <= lit_level::BRIGHT_ONLY ) {
+        luminance = 1.49f;
+    }
+    // fastexp is an approximation, so leave some headroom
+    constexpr float approximation_margin = 1.1f;
+    for( int dist = 1; dist < 60; dist++ ) {
+        if( approximation_margin * luminance / ( std::exp( min_transparency * dist ) * dist ) <=
+            LIGHT_AMBIENT_LOW ) {
+            // Row where light drops off is still lit
+            return dist + 1;
+        }
+    }
+    return 60;
+}
+
+void map::apply_buffered_light_sources( const int zlev )
+{
+    ZoneScoped;
+    level_cache &map_cache = get_cache( zlev );
+    four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y] = map_cache.lm;
+    float ( &sm )[MAPSIZE_X][MAPSIZE_Y] = map_cache.sm;
+    const float ( &light_source_buffer )[MAPSIZE_X][MAPSIZE_Y] = map_cache.light_source_buffer;
+    const diagonal_blocks( &blocked_cache )[MAPSIZE_X][MAPSIZE_Y] = map_cache.vehicle_obscured_cache;
+    const float ( &transparency_cache )[MAPSIZE_X][MAPSIZE_Y] = map_cache.transparency_cache;
+
+    if( !map_cache.buffered_light ) {
+        map_cache.buffered_light = cata::make_value<buffered_light_cache>();
+    }
+    buffered_light_cache &cached = *map_cache.buffered_light;
+
+    float min_transparency = LIGHT_TRANSPARENCY_OPEN_AIR;
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            if( transparency_cache[x][y] > LIGHT_TRANSPARENCY_SOLID ) {
+                min_transparency = std::min( min_transparency, transparency_cache[x][y] );
+            }
+        }
+    }
+
+    const bool rebuild_all = !cached.valid || cached.abs_sub != get_abs_sub() ||
+                             cached.weather_transparency != weather_transparency_lookup.transparency;
+    // Old light could have gone as far as the old transparency allowed, so clear at least that much
+    const float radius_transparency = rebuild_all ? min_transparency :
+                                      std::min( min_transparency, cached.min_transparency );
+
+    // Vehicles are recached every turn, so compare against what the light was cast with
+    std::bitset<MAPSIZE *MAPSIZE> occluders_dirty = map_cache.buffered_light_dirty;
+    if( !rebuild_all ) {
+        for( int smx = 0; smx < my_MAPSIZE; smx++ ) {
+            for( int smy = 0; smy < my_MAPSIZE; smy++ ) {
+                for( int sx = 0; sx < SEEX && !occluders_dirty[smx * MAPSIZE + smy]; sx++ ) {
+                    for( int sy = 0; sy < SEEY; sy++ ) {
+                        const diagonal_blocks &now = blocked_cache[smx * SEEX + sx][smy * SEEY + sy];
+                        const diagonal_blocks &then = cached.vehicle_obscured_cache[smx * SEEX + sx][smy * SEEY + sy];
+                        if( now.nw != then.nw || now.ne != then.ne ) {
+                            occluders_dirty.set( smx * MAPSIZE + smy );
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Area to be cleared and relit, as a 2D difference array of marked squares
+    std::vector<int> relight_area( ( MAPSIZE_X + 1 ) * ( MAPSIZE_Y + 1 ), 0 );
+    const auto relight_at = [&relight_area]( int x, int y ) -> int & {
+        return relight_area[x * ( MAPSIZE_Y + 1 ) + y];
+    };
+    const auto mark_relight = [&]( point p, int radius ) {
+        const point min( std::max( 0, p.x - radius ), std::max( 0, p.y - radius ) );
+        const point max( std::min( MAPSIZE_X, p.x + radius + 1 ), std::min( MAPSIZE_Y, p.y + radius + 1 ) );
+        relight_at( min.x, min.y )++;
+        relight_at( max.x, min.y )--;
+        relight_at( min.x, max.y )--;
+        relight_at( max.x, max.y )++;
+    };
+    const auto is_occluder_dirty_near = [&]( point p, int radius ) {
+        const int min_smx = std::max( 0, ( p.x - radius ) / SEEX );
+        const int max_smx = std::min( my_MAPSIZE - 1, ( p.x + radius ) / SEEX );
+        const int min_smy = std::max( 0, ( p.y - radius ) / SEEY );
+        const int max_smy = std::min( my_MAPSIZE - 1, ( p.y + radius ) / SEEY );
+        for( int smx = min_smx; smx <= max_smx; smx++ ) {
+            for( int smy = min_smy; smy <= max_smy; smy++ ) {
+                if( occluders_dirty[smx * MAPSIZE + smy] ) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    bool any_relight = rebuild_all;
+    if( !rebuild_all ) {
+        for( int x = 0; x < MAPSIZE_X; x++ ) {
+            for( int y = 0; y < MAPSIZE_Y; y++ ) {
+                const float old_luminance = cached.light_source_buffer[x][y];
+                const float new_luminance = light_source_buffer[x][y];
+                if( old_luminance <= 0.0f && new_luminance <= 0.0f ) {
+                    continue;
+                }
+                const point p( x, y );
+                const int radius = buffered_light_radius( std::max( old_luminance, new_luminance ),
+                                   radius_transparency );
+                bool changed = old_luminance != new_luminance;
+                // Neighbouring sources decide which directions this one is cast in
+                for( const point &dir : four_adjacent_offsets ) {
+                    const point n = p + dir;
+                    changed = changed || ( n.x >= 0 && n.y >= 0 && n.x < MAPSIZE_X && n.y < MAPSIZE_Y &&
+                                           cached.light_source_buffer[n.x][n.y] != light_source_buffer[n.x][n.y] );
+                }
+                if( changed || is_occluder_dirty_near( p, radius ) ) {
+                    mark_relight( p, radius );
+                    any_relight = true;
+                }
+            }
+        }
+    }
+
+    if( any_relight ) {
+        // Summed-area table of the area, so that overlap with a source's square is a constant time check
+        std::vector<int> relit_sum( ( MAPSIZE_X + 1 ) * ( MAPSIZE_Y + 1 ), 0 );
+        const auto relit_sum_at = [&relit_sum]( int x, int y ) -> int & {
+            return relit_sum[x * ( MAPSIZE_Y + 1 ) + y];
+        };
+        constexpr four_quadrants four_zeros( 0.0f );
+        for( int x = 0; x < MAPSIZE_X; x++ ) {
+            for( int y = 0; y < MAPSIZE_Y; y++ ) {
+                if( x > 0 ) {
+                    relight_at( x, y ) += relight_at( x - 1, y );
+                }
+                if( y > 0 ) {
+                    relight_at( x, y ) += relight_at( x, y - 1 );
+                }
+                if( x > 0 && y > 0 ) {
+                    relight_at( x, y ) -= relight_at( x - 1, y - 1 );
+                }
+                const bool relit = rebuild_all || relight_at( x, y ) > 0;
+                if( relit ) {
+                    cached.lm[x][y] = four_zeros;
+                    cached.sm[x][y] = 0.0f;
+                }
+                relit_sum_at( x + 1, y + 1 ) = relit_sum_at( x, y + 1 ) + relit_sum_at( x + 1, y ) -
+                                               relit_sum_at( x, y ) + ( relit ? 1 : 0 );
+            }
+        }
+
+        for( int x = 0; x < MAPSIZE_X; x++ ) {
+            for( int y = 0; y < MAPSIZE_Y; y++ ) {
+                const float luminance = light_source_buffer[x][y];
+                if( luminance <= 0.0f ) {
+                    continue;
+                }
+                // Light is combined by taking the maximum, so recasting sources over tiles
+                //   that were not cleared doesn't change them
+                const int radius = buffered_light_radius( luminance, radius_transparency );
+                const point min( std::max( 0, x - radius ), std::max( 0, y - radius ) );
+                const point max( std::min( MAPSIZE_X, x + radius + 1 ), std::min( MAPSIZE_Y, y + radius + 1 ) );
+                const int relit_count = relit_sum_at( max.x, max.y ) - relit_sum_at( min.x, max.y ) -
+                                        relit_sum_at( max.x, min.y ) + relit_sum_at( min.x, min.y );
+                if( relit_count > 0 ) {
+                    apply_light_source( tripoint( x, y, zlev ), luminance, cached.lm, cached.sm );
+                }
+            }
+        }
+    }
+
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            lm[x][y] = elementwise_max( lm[x][y], cached.lm[x][y] );
+            sm[x][y] = std::max( sm[x][y], cached.sm[x][y] );
+        }
+    }
+
+    std::copy_n( &light_source_buffer[0][0], MAPSIZE_X * MAPSIZE_Y, &cached.light_source_buffer[0][0] );
+    std::copy_n( &blocked_cache[0][0], MAPSIZE_X * MAPSIZE_Y, &cached.vehicle_obscured_cache[0][0] );
+    cached.min_transparency = min_transparency;
+    cached.weather_transparency = weather_transparency_lookup.transparency;
+    cached.abs_sub = get_abs_sub();
+    cached.valid = true;
+    map_cache.buffered_light_dirty.reset();
+}
+
 void map::add_light_source( const tripoint &p, float luminance )
 {
     auto &light_source_buffer = get_cache( p.z ).light_source_buffer;
@@ -953,6 +1145,10 @@ void cast_zlight_segment(
         bool started_block = false;
         T current_transparency = 0.0f;
         bool current_floor = false;
+        // `calc` is an exponent and is the same for the whole row save for distance changes,
+        //   so only recalculate it when distance changes, same as castLight does on slow paths
+        int last_dist = -1;
+        T last_calc = 0.0f;
 
         int z_start = z_skip != -1 ? z_skip : std::max( 0,
                       static_cast<int>( std::ceil( ( ( distance - 0.5f ) * start_major ) - 0.5f ) ) );
@@ -1007,7 +1203,11 @@ void cast_zlight_segment(
                 }
 
                 const int dist = rl_dist( tripoint_zero, delta ) + offset_distance;
-                T last_intensity = calc( numerator, cumulative_transparency, dist );
+                if( dist != last_dist ) {
+                    last_calc = calc( numerator, cumulative_transparency, dist );
+                    last_dist = dist;
+                }
+                T last_intensity = last_calc;
                 ( *output_caches[z_index] )[current.x][current.y] =
                     std::max( ( *output_caches[z_index] )[current.x][current.y], last_intensity );
 
@@ -1713,6 +1913,67 @@ void map::build_seen_cache( const tripoint &origin, const int target_z )
     }
 }
 
+// Roughly where one shadowcast over the reality bubble gets cheaper than tracing that many lines.
+static constexpr size_t batch_shadowcast_threshold = 100;
+
+std::vector<bool> map::sees( const std::vector<tripoint> &observers,
+                             const std::vector<tripoint> &targets, const int range ) const
+{
+    ZoneScoped;
+
+    std::vector<bool> result( observers.size() * targets.size(), false );
+    // Targets of the current observer that aren't out of range or already cached
+    std::vector<size_t> pending;
+    for( size_t o = 0; o < observers.size(); o++ ) {
+        const tripoint &from = observers[o];
+        const size_t row = o * targets.size();
+        pending.clear();
+        size_t pending_same_z = 0;
+        for( size_t t = 0; t < targets.size(); t++ ) {
+            const tripoint &to = targets[t];
+            if( ( range >= 0 && range < rl_dist( from, to ) ) || !inbounds( to ) ) {
+                continue;
+            }
+            if( const std::optional<bool> cached = skew_vision_cache.get( from, to ) ) {
+                result[row + t] = *cached;
+                continue;
+            }
+            pending.push_back( t );
+            if( to.z == from.z ) {
+                pending_same_z++;
+            }
+        }
+
+        if( pending_same_z < batch_shadowcast_threshold || !inbounds( from ) ) {
+            for( const size_t t : pending ) {
+                result[row + t] = sees( from, targets[t], range );
+            }
+            continue;
+        }
+
+        if( !batch_sight_buffer ) {
+            batch_sight_buffer = std::make_unique<sight_buffer>();
+        }
+        float ( &seen )[MAPSIZE_X][MAPSIZE_Y] = batch_sight_buffer->seen;
+        std::uninitialized_fill_n( &seen[0][0], MAPSIZE_X * MAPSIZE_Y, LIGHT_TRANSPARENCY_SOLID );
+        seen[from.x][from.y] = VISIBILITY_FULL;
+        const level_cache &map_cache = get_cache_ref( from.z );
+        castLightAllWithLookup<float, float, sight_calc, sight_check, update_light, accumulate_transparency, sight_from_lookup>
+        ( seen, map_cache.transparency_cache, map_cache.vehicle_obscured_cache, from.xy(), 0 );
+
+        for( const size_t t : pending ) {
+            const tripoint &to = targets[t];
+            if( to.z != from.z ) {
+                result[row + t] = sees( from, to, range );
+                continue;
+            }
+            // Not cached, the cache holds line results that sees() relies on
+            result[row + t] = seen[to.x][to.y] > LIGHT_TRANSPARENCY_SOLID;
+        }
+    }
+    return result;
+}
+
 //Schraudolph's algorithm with John's constants
 static inline
 float fastexp( float x )
@@ -1752,8 +2013,13 @@ static float light_from_lookup( const float &numerator, const float &transparenc
 void map::apply_light_source( const tripoint &p, float luminance )
 {
     auto &cache = get_cache( p.z );
-    four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y] = cache.lm;
-    float ( &sm )[MAPSIZE_X][MAPSIZE_Y] = cache.sm;
+    apply_light_source( p, luminance, cache.lm, cache.sm );
+}
+
+void map::apply_light_source( const tripoint &p, float luminance,
+                              four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y], float ( &sm )[MAPSIZE_X][MAPSIZE_Y] )
+{
+    auto &cache = get_cache( p.z );
     float ( &transparency_cache )[MAPSIZE_X][MAPSIZE_Y] = cache.transparency_cache;
     float ( &light_source_buffer )[MAPSIZE_X][MAPSIZE_Y] = cache.light_source_buffer;
     diagonal_blocks( &blocked_cache )[MAPSIZE_X][MAPSIZE_Y] = cache.vehicle_obscured_cache;
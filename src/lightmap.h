@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
 #include <ostream>
 
 static constexpr float LIGHT_SOURCE_LOCAL = 0.1f;
@@ -38,7 +39,8 @@ static constexpr float VISIBILITY_FULL = 1.0f;
 
 #define LIGHT_RANGE(b) static_cast<int>( -std::log(LIGHT_AMBIENT_LOW / static_cast<float>(b)) * (1.0 / LIGHT_TRANSPARENCY_OPEN_AIR) )
 
-enum class lit_level : int {
+// Stored per tile in level_cache::visibility_cache, so kept to a byte
+enum class lit_level : std::uint8_t {
     DARK = 0,
     LOW, // Hard to see
     BRIGHT_ONLY, // bright but indistinct
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "point.h"
+
+/**
+ * Fixed-size cache of line of sight results between pairs of points.
+ *
+ * Entries live in a single flat table with open addressing, so lookups and inserts never allocate
+ * once the table exists. When the probe window around a key is full, the key's home slot is
+ * overwritten instead of evicting in LRU order.
+ * Invalidating bumps a generation counter instead of touching the table, entries from older
+ * generations are treated as empty.
+ */
+class los_cache
+{
+    public:
+        /** Number of slots, enough for every pair seen during a busy turn. */
+        static constexpr int capacity_bits = 17;
+        static constexpr size_t capacity = size_t( 1 ) << capacity_bits;
+        /** How many slots past the home slot of a key are checked before giving up. */
+        static constexpr size_t max_probe = 8;
+
+        /** Cached visibility between `a` and `b`, in either order, or nothing if not cached. */
+        std::optional<bool> get( const tripoint &a, const tripoint &b ) const {
+            if( !slots ) {
+                return std::nullopt;
+            }
+            const uint64_t key = make_key( a, b );
+            const size_t home = slot_index( key );
+            for( size_t i = 0; i < max_probe; i++ ) {
+                const slot &s = slots[( home + i ) & ( capacity - 1 )];
+                if( s.generation != generation ) {
+                    // Inserts fill the first free slot, so nothing further along can match
+                    return std::nullopt;
+                }
+                if( s.key == key ) {
+                    return s.visible;
+                }
+            }
+            return std::nullopt;
+        }
+
+        void insert( const tripoint &a, const tripoint &b, bool visible ) {
+            if( !slots ) {
+                slots = std::make_unique<slot[]>( capacity );
+            }
+            const uint64_t key = make_key( a, b );
+            const size_t home = slot_index( key );
+            slot *target = &slots[home];
+            for( size_t i = 0; i < max_probe; i++ ) {
+                slot &s = slots[( home + i ) & ( capacity - 1 )];
+                if( s.generation != generation || s.key == key ) {
+                    target = &s;
+                    break;
+                }
+            }
+            target->key = key;
+            target->generation = generation;
+            target->visible = visible;
+        }
+
+        /** Forget every entry. Constant time, the table is only wiped when the generation wraps. */
+        void invalidate() {
+            generation++;
+            if( generation == 0 ) {
+                if( slots ) {
+                    std::fill( slots.get(), slots.get() + capacity, slot() );
+                }
+                generation = 1;
+            }
+        }
+
+    private:
+        struct slot {
+            uint64_t key = 0;
+            uint32_t generation = 0;
+            bool visible = false;
+        };
+
+        static uint32_t pack( const tripoint &p ) {
+            // 12 bits per horizontal coordinate is plenty for the reality bubble
+            return ( static_cast<uint32_t>( p.x ) & 0xFFF ) << 20 |
+                   ( static_cast<uint32_t>( p.y ) & 0xFFF ) << 8 |
+                   ( static_cast<uint32_t>( p.z ) & 0xFF );
+        }
+
+        static uint64_t make_key( const tripoint &a, const tripoint &b ) {
+            // Canonical order, so the cache is reflexive
+            const uint64_t pa = pack( a );
+            const uint64_t pb = pack( b );
+            return pa < pb ? pa << 32 | pb : pb << 32 | pa;
+        }
+
+        static size_t slot_index( uint64_t key ) {
+            // Fibonacci hashing, the top bits of the product are well mixed
+            return static_cast<size_t>( ( key * 0x9E3779B97F4A7C15ULL ) >> ( 64 - capacity_bits ) );
+        }
+
+        /** Allocated on first insert, most maps (e.g. tinymaps) never check line of sight. */
+        std::unique_ptr<slot[]> slots;
+        uint32_t generation = 1;
+};
@@ -75,6 +75,7 @@
 #include "output.h"
 #include "overmapbuffer.h"
 #include "legacy_pathfinding.h"
+#include "pathfinding.h"
 #include "player.h"
 #include "point_float.h"
 #include "projectile.h"
@@ -86,6 +87,7 @@
 #include "string_formatter.h"
 #include "string_id.h"
 #include "submap.h"
+#include "thread_pool.h"
 #include "tileray.h"
 #include "timed_event.h"
 #include "translations.h"
@@ -355,6 +357,7 @@ void map::add_vehicle_to_cache( vehicle *veh )
         if( inbounds( p ) ) {
             ch.veh_exists_at[p.x][p.y] = true;
         }
+        set_pathfinding_cache_dirty( p );
     }
 
     last_full_vehicle_list_dirty = true;
@@ -371,6 +374,7 @@ void map::clear_vehicle_point_from_cache( vehicle *veh, const tripoint &pt )
     if( inbounds( pt ) ) {
         ch.veh_exists_at[pt.x][pt.y] = false;
     }
+    set_pathfinding_cache_dirty( pt );
     auto it = ch.veh_cached_parts.find( pt );
     if( it != ch.veh_cached_parts.end() && it->second.first == veh ) {
         ch.veh_cached_parts.erase( it );
@@ -570,12 +574,7 @@ bool map::vehproceed( VehicleList &vehicle_list )
 
         // Check if any vehicles exist in the active range for this z-level
         cache.veh_in_active_range = cache.veh_in_active_range &&
-                                    std::ranges::any_of( cache.veh_exists_at,
-        []( const auto & row ) {
-            return std::any_of( std::begin( row ), std::end( row ), []( bool veh_exists ) {
-                return veh_exists;
-            } );
-        } );
+                                    cache.veh_exists_at.any();
     }
 
     return true;
@@ -1520,7 +1519,7 @@ void map::furn_set( const tripoint &p, const furn_id &new_furniture,
     set_memory_seen_cache_dirty( p );
 
     // TODO: Limit to changes that affect move cost, traps and stairs
-    set_pathfinding_cache_dirty( p.z );
+    set_pathfinding_cache_dirty( p );
 
     // Make sure the furniture falls if it needs to
     support_dirty( p );
@@ -1855,7 +1854,7 @@ bool map::ter_set( const tripoint &p, const ter_id &new_terrain )
     set_memory_seen_cache_dirty( p );
 
     // TODO: Limit to changes that affect move cost, traps and stairs
-    set_pathfinding_cache_dirty( p.z );
+    set_pathfinding_cache_dirty( p );
 
     tripoint above( p.xy(), p.z + 1 );
     // Make sure that if we supported something and no longer do so, it falls down
@@ -5030,7 +5029,7 @@ bool map::has_items( const tripoint &p ) const
     }
 
     point l;
-    submap *const current_submap = get_submap_at( p, l );
+    const submap *const current_submap = get_submap_at( p, l );
 
     return !current_submap->get_items( l ).empty();
 }
@@ -5504,6 +5503,7 @@ void map::trap_set( const tripoint &p, const trap_id &type )
     if( type != tr_null ) {
         traplocs[type.to_i()].push_back( p );
     }
+    set_pathfinding_cache_dirty( p );
 }
 
 void map::disarm_trap( const tripoint &p )
@@ -5585,6 +5585,7 @@ void map::remove_trap( const tripoint &p )
         if( iter != traps.end() ) {
             traps.erase( iter );
         }
+        set_pathfinding_cache_dirty( p );
     }
 }
 /*
@@ -5598,7 +5599,7 @@ const field &map::field_at( const tripoint &p ) const
     }
 
     point l;
-    submap *const current_submap = get_submap_at( p, l );
+    const submap *const current_submap = get_submap_at( p, l );
 
     return current_submap->get_field( l );
 }
@@ -5752,7 +5753,7 @@ bool map::add_field( const tripoint &p, const field_type_id &type_id, int intens
     }
 
     if( fd_type.is_dangerous() ) {
-        set_pathfinding_cache_dirty( p.z );
+        set_pathfinding_cache_dirty( p );
     }
 
     // Ensure blood type fields don't hang in the air
@@ -5784,7 +5785,7 @@ void map::remove_field( const tripoint &p, const field_type_id &field_to_remove
             set_seen_cache_dirty( p );
         }
         if( fdata.is_dangerous() ) {
-            set_pathfinding_cache_dirty( p.z );
+            set_pathfinding_cache_dirty( p );
         }
     }
 }
@@ -6423,17 +6424,8 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range,
         bresenham_slope = 0;
         return false; // Out of range!
     }
-    // Cannonicalize the order of the tripoints so the cache is reflexive.
-    const tripoint &min = F < T ? F : T;
-    const tripoint &max = !( F < T ) ? F : T;
-    // A little gross, just pack the values into a point.
-    const point key(
-        min.x << 16 | min.y << 8 | ( min.z + OVERMAP_DEPTH ),
-        max.x << 16 | max.y << 8 | ( max.z + OVERMAP_DEPTH )
-    );
-    char cached = skew_vision_cache.get( key, -1 );
-    if( cached >= 0 ) {
-        return cached > 0;
+    if( const std::optional<bool> cached = skew_vision_cache.get( F, T ) ) {
+        return *cached;
     }
 
     bool visible = true;
@@ -6456,7 +6448,7 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range,
             last_point = new_point;
             return true;
         } );
-        skew_vision_cache.insert( 100000, key, visible ? 1 : 0 );
+        skew_vision_cache.insert( F, T, visible );
         return visible;
     }
 
@@ -6489,7 +6481,7 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range,
         last_point = new_point;
         return true;
     } );
-    skew_vision_cache.insert( 100000, key, visible ? 1 : 0 );
+    skew_vision_cache.insert( F, T, visible );
     return visible;
 }
 
@@ -7186,6 +7178,36 @@ void map::shift( point sp )
     }
 }
 
+std::vector<tripoint> map::submaps_ahead( point direction ) const
+{
+    const tripoint abs = get_abs_sub();
+    const int zmin = zlevels ? -OVERMAP_DEPTH : abs.z;
+    const int zmax = zlevels ? OVERMAP_HEIGHT : abs.z;
+    // The column and/or row just outside the map, including the corner for diagonal moves
+    const int ahead_x = direction.x > 0 ? my_MAPSIZE : -1;
+    const int ahead_y = direction.y > 0 ? my_MAPSIZE : -1;
+    std::vector<tripoint> ahead;
+    for( int gx = -1; gx <= my_MAPSIZE; gx++ ) {
+        for( int gy = -1; gy <= my_MAPSIZE; gy++ ) {
+            if( ( direction.x == 0 || gx != ahead_x ) && ( direction.y == 0 || gy != ahead_y ) ) {
+                continue;
+            }
+            for( int gz = zmin; gz <= zmax; gz++ ) {
+                ahead.emplace_back( abs.x + gx, abs.y + gy, gz );
+            }
+        }
+    }
+    return ahead;
+}
+
+void map::prefetch_submaps( point direction ) const
+{
+    if( direction == point_zero ) {
+        return;
+    }
+    MAPBUFFER.prefetch( submaps_ahead( direction ) );
+}
+
 void map::vertical_shift( const int newz )
 {
     if( !zlevels ) {
@@ -7260,21 +7282,66 @@ static void generate_uniform( const tripoint &p, const ter_id &terrain_type )
     for( int xd = 0; xd <= 1; xd++ ) {
         for( int yd = 0; yd <= 1; yd++ ) {
             tripoint pos = p + point( xd, yd );
-            submap *sm = new submap( sm_to_ms_copy( pos ) );
-            sm->is_uniform = true;
-            sm->set_all_ter( terrain_type );
+            submap *sm = new submap( sm_to_ms_copy( pos ), terrain_type );
             sm->last_touched = calendar::turn;
             MAPBUFFER.add_submap( pos, sm );
         }
     }
 }
 
-void map::loadn( const tripoint &grid, const bool update_vehicles )
+// Overmap terrains made of a single terrain, which don't need full mapgen
+static std::optional<ter_id> uniform_terrain( const oter_id &terrain_type )
 {
     // Cache empty overmap types
     static const oter_id rock( "empty_rock" );
     static const oter_id air( "open_air" );
 
+    // TODO: Replace with json mapgen functions.
+    if( terrain_type == air ) {
+        return t_open_air;
+    } else if( terrain_type == rock ) {
+        return t_rock;
+    }
+    return std::nullopt;
+}
+
+// Generates the 2x2 submaps of an overmap terrain and adds them to the mapbuffer
+static void generate_omt( const tripoint_abs_omt &p )
+{
+    const tripoint sm_pos = omt_to_sm_copy( p.raw() );
+    const oter_id terrain_type = overmap_buffer.ter( p );
+
+    // Short-circuit if the map tile is uniform
+    if( const std::optional<ter_id> uniform = uniform_terrain( terrain_type ) ) {
+        generate_uniform( sm_pos, *uniform );
+    } else {
+        // Independent of when, and in which order, overmap terrains are generated
+        const scoped_rng_seed seed( rng_location_seed( g->get_seed(), rng_seed_domain::mapgen,
+                                    p.raw() ) );
+        tinymap tmp_map;
+        tmp_map.generate( sm_pos, calendar::turn );
+    }
+}
+
+void map::pregenerate_submaps( point direction, int max_mapgen ) const
+{
+    if( direction == point_zero ) {
+        return;
+    }
+    for( const tripoint &om_addr : MAPBUFFER.ungenerated_quads( submaps_ahead( direction ) ) ) {
+        const tripoint_abs_omt omt( om_addr );
+        if( !uniform_terrain( overmap_buffer.ter( omt ) ) ) {
+            if( max_mapgen <= 0 ) {
+                continue;
+            }
+            max_mapgen--;
+        }
+        generate_omt( omt );
+    }
+}
+
+void map::loadn( const tripoint &grid, const bool update_vehicles )
+{
     const tripoint grid_abs_sub = abs_sub.xy() + grid;
     const size_t gridn = get_nonant( grid );
 
@@ -7289,21 +7356,7 @@ void map::loadn( const tripoint &grid, const bool update_vehicles )
         // Each overmap square is two nonants; to prevent overlap, generate only at
         //  squares divisible by 2.
         // TODO: fix point types
-        const tripoint_abs_omt grid_abs_omt( sm_to_omt_copy( grid_abs_sub ) );
-        const tripoint grid_abs_sub_rounded = omt_to_sm_copy( grid_abs_omt.raw() );
-
-        const oter_id terrain_type = overmap_buffer.ter( grid_abs_omt );
-
-        // Short-circuit if the map tile is uniform
-        // TODO: Replace with json mapgen functions.
-        if( terrain_type == air ) {
-            generate_uniform( grid_abs_sub_rounded, t_open_air );
-        } else if( terrain_type == rock ) {
-            generate_uniform( grid_abs_sub_rounded, t_rock );
-        } else {
-            tinymap tmp_map;
-            tmp_map.generate( grid_abs_sub_rounded, calendar::turn );
-        }
+        generate_omt( tripoint_abs_omt( sm_to_omt_copy( grid_abs_sub ) ) );
 
         // This is the same call to MAPBUFFER as above!
         tmpsub = MAPBUFFER.lookup_submap( grid_abs_sub );
@@ -7780,6 +7833,8 @@ void map::actualize( const tripoint &grid )
 
     const time_duration time_since_last_actualize = calendar::turn - tmpsub->last_touched;
     const bool do_funnels = ( grid.z >= 0 );
+    // Read through this where possible, so that uniform submaps keep sharing their tiles
+    const submap &readonly_sub = *tmpsub;
 
     // check spoiled stuff, and fill up funnels while we're at it
     for( int x = 0; x < SEEX; x++ ) {
@@ -7791,7 +7846,7 @@ void map::actualize( const tripoint &grid )
                 field_furn_locs.push_back( pnt );
             }
             // plants contain a seed item which must not be removed under any circumstances
-            if( !furn.has_flag( "DONT_REMOVE_ROTTEN" ) ) {
+            if( !furn.has_flag( "DONT_REMOVE_ROTTEN" ) && !readonly_sub.get_items( p ).empty() ) {
                 temperature_flag temperature = temperature_flag_at_point( *this, pnt );
                 remove_rotten_items( tmpsub->get_items( { x, y } ), pnt, temperature );
             }
@@ -7817,7 +7872,9 @@ void map::actualize( const tripoint &grid )
 
             rad_scorch( pnt, time_since_last_actualize );
 
-            decay_cosmetic_fields( pnt, time_since_last_actualize );
+            if( readonly_sub.get_field( p ).field_count() > 0 ) {
+                decay_cosmetic_fields( pnt, time_since_last_actualize );
+            }
         }
     }
 
@@ -8282,8 +8339,7 @@ void map::build_outside_cache( const int zlev )
 
     auto &outside_cache = ch.outside_cache;
     if( zlev < 0 ) {
-        std::uninitialized_fill_n(
-            &outside_cache[0][0], ( MAPSIZE_X ) * ( MAPSIZE_Y ), false );
+        outside_cache.fill( false );
         return;
     }
 
@@ -8315,7 +8371,9 @@ void map::build_outside_cache( const int zlev )
 
     // Copy the padded cache back to the proper one, but with no padding
     for( int x = 0; x < SEEX * my_MAPSIZE; x++ ) {
-        std::copy_n( &padded_cache[x + 1][1], SEEX * my_MAPSIZE, &outside_cache[x][0] );
+        for( int y = 0; y < SEEY * my_MAPSIZE; y++ ) {
+            outside_cache[x][y] = padded_cache[x + 1][y + 1];
+        }
     }
 
     ch.outside_cache_dirty = false;
@@ -8596,19 +8654,39 @@ void map::build_map_cache( const int zlev, bool skip_lightmap )
     const int minz = zlevels ? -OVERMAP_DEPTH : zlev;
     const int maxz = zlevels ? OVERMAP_HEIGHT : zlev;
     bool seen_cache_dirty = false;
-    for( int z = minz; z <= maxz; z++ ) {
-        // trigger FOV recalculation only when there is a change on the player's level or if fov_3d is enabled
-        const bool affects_seen_cache =  z == zlev || fov_3d;
-        build_outside_cache( z );
-        build_transparency_cache( z );
-        update_suspension_cache( z );
-        seen_cache_dirty |= ( build_floor_cache( z ) && affects_seen_cache );
-        seen_cache_dirty |= get_cache( z ).seen_cache_dirty && affects_seen_cache;
+
+    // Shared by all z-levels, so it has to be up to date before they are built in parallel
+    update_weather_transparency_lookup();
+
+    // Levels only read submaps and write their own level_cache here, so they can be built in parallel.
+    // Floor cache also reads the submaps of the level below, which aren't modified.
+    std::array<bool, OVERMAP_LAYERS> floor_cache_rebuilt = {};
+    std::array<bool, OVERMAP_LAYERS> transparency_cache_rebuilt = {};
+    // Building a level can complain about unloaded submaps, which is reported from here afterwards
+    std::array<std::vector<deferred_debugmsg>, OVERMAP_LAYERS> messages;
+    get_thread_pool().parallel_for( minz, maxz + 1, [&]( const int z ) {
+        messages[z + OVERMAP_DEPTH] = collect_debugmsgs_during( [&]() {
+            build_outside_cache( z );
+            transparency_cache_rebuilt[z + OVERMAP_DEPTH] = build_transparency_cache( z );
+            floor_cache_rebuilt[z + OVERMAP_DEPTH] = build_floor_cache( z );
+        } );
         diagonal_blocks fill = {false, false};
         std::uninitialized_fill_n( &( get_cache( z ).vehicle_obscured_cache[0][0] ), MAPSIZE_X * MAPSIZE_Y,
                                    fill );
         std::uninitialized_fill_n( &( get_cache( z ).vehicle_obstructed_cache[0][0] ),
                                    MAPSIZE_X * MAPSIZE_Y, fill );
+    }, get_option<bool>( "PARALLEL_MAP_CACHE" ) );
+
+    // Merged in z order, same as when built on a single thread
+    bool los_dirty = false;
+    for( int z = minz; z <= maxz; z++ ) {
+        replay_debugmsgs( messages[z + OVERMAP_DEPTH] );
+        los_dirty |= transparency_cache_rebuilt[z + OVERMAP_DEPTH];
+        // trigger FOV recalculation only when there is a change on the player's level or if fov_3d is enabled
+        const bool affects_seen_cache =  z == zlev || fov_3d;
+        update_suspension_cache( z );
+        seen_cache_dirty |= ( floor_cache_rebuilt[z + OVERMAP_DEPTH] && affects_seen_cache );
+        seen_cache_dirty |= get_cache( z ).seen_cache_dirty && affects_seen_cache;
     }
     // needs a separate pass as it changes the caches on neighbour z-levels (e.g. floor_cache);
     // otherwise such changes might be overwritten by main cache-building logic
@@ -8618,8 +8696,8 @@ void map::build_map_cache( const int zlev, bool skip_lightmap )
 
     seen_cache_dirty |= build_vision_transparency_cache( get_player_character() );
 
-    if( seen_cache_dirty ) {
-        skew_vision_cache.clear();
+    if( seen_cache_dirty || los_dirty ) {
+        skew_vision_cache.invalidate();
     }
     // Initial value is illegal player position.
     const tripoint &p = g->u.pos();
@@ -9168,7 +9246,8 @@ level_cache::level_cache()
     std::fill_n( &lm[0][0], map_dimensions, four_zeros );
     std::fill_n( &sm[0][0], map_dimensions, 0.0f );
     std::fill_n( &light_source_buffer[0][0], map_dimensions, 0.0f );
-    std::fill_n( &outside_cache[0][0], map_dimensions, false );
+    buffered_light_dirty.set();
+    outside_cache.fill( false );
     std::fill_n( &floor_cache[0][0], map_dimensions, false );
     std::fill_n( &transparency_cache[0][0], map_dimensions, 0.0f );
     diagonal_blocks fill = {false, false};
@@ -9178,7 +9257,7 @@ level_cache::level_cache()
     std::fill_n( &camera_cache[0][0], map_dimensions, 0.0f );
     std::fill_n( &visibility_cache[0][0], map_dimensions, lit_level::DARK );
     veh_in_active_range = false;
-    std::fill_n( &veh_exists_at[0][0], map_dimensions, false );
+    veh_exists_at.fill( false );
 }
 
 pathfinding_cache::pathfinding_cache()
@@ -9197,6 +9276,20 @@ void map::set_pathfinding_cache_dirty( const int zlev )
 {
     if( inbounds_z( zlev ) ) {
         get_pathfinding_cache( zlev ).dirty = true;
+        if( g != nullptr && this == &get_map() ) {
+            Pathfinding::invalidate_d_maps( zlev );
+        }
+    }
+}
+
+void map::set_pathfinding_cache_dirty( const tripoint &p )
+{
+    if( inbounds_z( p.z ) ) {
+        // Legacy pathfinding cache is only tracked per z-level
+        get_pathfinding_cache( p.z ).dirty = true;
+        if( g != nullptr && this == &get_map() ) {
+            Pathfinding::invalidate_d_maps( p );
+        }
     }
 }
 
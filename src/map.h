@@ -15,6 +15,7 @@
 #include <utility>
 #include <vector>
 
+#include "bitset_grid.h"
 #include "bodypart.h"
 #include "calendar.h"
 #include "coordinate_conversions.h"
@@ -26,13 +27,14 @@
 #include "item_stack.h"
 #include "lightmap.h"
 #include "line.h"
-#include "lru_cache.h"
+#include "los_cache.h"
 #include "mapdata.h"
 #include "memory_fast.h"
 #include "point.h"
 #include "shadowcasting.h"
 #include "type_id.h"
 #include "units.h"
+#include "value_ptr.h"
 
 enum class spawn_disposition;
 struct scent_block;
@@ -294,6 +296,22 @@ struct diagonal_blocks {
     bool ne;
 };
 
+// Light cast by bulk light sources (see level_cache::light_source_buffer) on the last generate_lightmap.
+// Kept between turns so that only the sources that changed, or had their surroundings changed, are recast.
+struct buffered_light_cache {
+    bool valid = false;
+    tripoint abs_sub;
+    // Lowest non-opaque transparency on the level, bounds how far the light could have gone
+    float min_transparency = LIGHT_TRANSPARENCY_OPEN_AIR;
+    // Weather fast path the light was cast with
+    float weather_transparency = LIGHT_TRANSPARENCY_OPEN_AIR;
+    four_quadrants lm[MAPSIZE_X][MAPSIZE_Y];
+    float sm[MAPSIZE_X][MAPSIZE_Y];
+    // What the above was cast from
+    float light_source_buffer[MAPSIZE_X][MAPSIZE_Y];
+    diagonal_blocks vehicle_obscured_cache[MAPSIZE_X][MAPSIZE_Y];
+};
+
 struct level_cache {
     // Zeros all relevant values
     level_cache();
@@ -312,10 +330,13 @@ struct level_cache {
     // To prevent redundant ray casting into neighbors: precalculate bulk light source positions.
     // This is only valid for the duration of generate_lightmap
     float light_source_buffer[MAPSIZE_X][MAPSIZE_Y];
+    // Submaps whose transparency changed since buffered light was cast, same layout as transparency_cache_dirty
+    std::bitset<MAPSIZE *MAPSIZE> buffered_light_dirty;
+    cata::value_ptr<buffered_light_cache> buffered_light;
 
     // if false, means tile is under the roof ("inside"), true means tile is "outside"
     // "inside" tiles are protected from sun, rain, etc. (see "INDOORS" flag)
-    bool outside_cache[MAPSIZE_X][MAPSIZE_Y];
+    cata::bitset_grid<MAPSIZE_X, MAPSIZE_Y> outside_cache;
 
     // true when vehicle below has "ROOF" or "OPAQUE" part, furniture below has "SUN_ROOF_ABOVE"
     //      or terrain doesn't have "NO_FLOOR" flag
@@ -348,7 +369,7 @@ struct level_cache {
     std::bitset<MAPSIZE *MAPSIZE> field_cache;
 
     bool veh_in_active_range;
-    bool veh_exists_at[MAPSIZE_X][MAPSIZE_Y];
+    cata::bitset_grid<MAPSIZE_X, MAPSIZE_Y> veh_exists_at;
     std::map< tripoint, std::pair<vehicle *, int> > veh_cached_parts;
     std::set<vehicle *> vehicle_list;
     std::set<vehicle *> zone_vehicles;
@@ -420,6 +441,8 @@ class map
         void set_suspension_cache_dirty( const int zlev );
 
         void set_pathfinding_cache_dirty( int zlev );
+        // Only invalidates pathfinding data that depends on the tile at `p`
+        void set_pathfinding_cache_dirty( const tripoint &p );
         /*@}*/
 
         void set_memory_seen_cache_dirty( const tripoint &p );
@@ -513,6 +536,17 @@ class map
          * Note: the map must have been loaded before this can be called.
          */
         void shift( point s );
+        /**
+         * Start reading the submaps that the next shift in `direction` would load on another thread,
+         * see @ref mapbuffer::prefetch. Only the signs of `direction` matter.
+         */
+        void prefetch_submaps( point direction ) const;
+        /**
+         * Generates overmap terrains that the next shift in `direction` would load, if they were
+         * never generated. Needs a finished @ref prefetch_submaps to know which ones those are.
+         * Uniform ones are cheap and always done, at most `max_mapgen` need full mapgen.
+         */
+        void pregenerate_submaps( point direction, int max_mapgen ) const;
         /**
          * Moves the map vertically to (not by!) newz.
          * Does not actually shift anything, only forces cache updates.
@@ -614,6 +648,17 @@ class map
         * Returns whether `F` sees `T` with a view range of `range`.
         */
         bool sees( const tripoint &F, const tripoint &T, int range ) const;
+        /**
+         * Line of sight from every one of `observers` to every one of `targets`,
+         * as if calling `sees( observer, target, range )` for each pair.
+         * Result for a pair is at index `observer * targets.size() + target`.
+         *
+         * Observers with many targets on their own z-level get one shadowcast instead of a line
+         * per target, which can disagree with the line on targets just past a corner.
+         * Only line results are cached, shadowcast ones are recomputed on each call.
+         */
+        std::vector<bool> sees( const std::vector<tripoint> &observers,
+                                const std::vector<tripoint> &targets, int range ) const;
     private:
         /**
          * Don't expose the slope adjust outside map functions.
@@ -1789,6 +1834,8 @@ class map
         // Builds a transparency cache and returns true if the cache was invalidated.
         // Used to determine if seen cache should be rebuilt.
         bool build_transparency_cache( int zlev );
+        // Updates the shadowcasting fast path lookup for current weather, which is shared by all z-levels
+        void update_weather_transparency_lookup();
         bool build_vision_transparency_cache( const Character &player );
         // fills lm with sunlight. pzlev is current player's zlevel
         void build_sunlight_cache( int pzlev );
@@ -1803,6 +1850,8 @@ class map
         void update_suspension_cache( const int &z );
     protected:
         void generate_lightmap( int zlev );
+        // Applies light from light_source_buffer, only recasting sources that changed since last time
+        void apply_buffered_light_sources( int zlev );
         void build_seen_cache( const tripoint &origin, int target_z );
         void apply_character_light( Character &who );
 
@@ -1836,6 +1885,9 @@ class map
     private:
         field &get_field( const tripoint &p );
 
+        /** Absolute positions of the submaps just outside the map in `direction`, on all z-levels. */
+        std::vector<tripoint> submaps_ahead( point direction ) const;
+
         /**
          * Get the submap pointer with given index in @ref grid, the index must be valid!
          */
@@ -1910,6 +1962,8 @@ class map
         int determine_wall_corner( const tripoint &p ) const;
         // apply a circular light pattern immediately, however it's best to use...
         void apply_light_source( const tripoint &p, float luminance );
+        void apply_light_source( const tripoint &p, float luminance,
+                                 four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y], float ( &sm )[MAPSIZE_X][MAPSIZE_Y] );
         // ...this, which will apply the light after at the end of generate_lightmap, and prevent redundant
         // light rays from causing massive slowdowns, if there's a huge amount of light.
         void add_light_source( const tripoint &p, float luminance );
@@ -1997,8 +2051,17 @@ class map
 
         /**
          * Cache of coordinate pairs recently checked for visibility.
+         * Invalidated whenever rebuilding the transparency caches changed anything.
          */
-        mutable lru_cache<point, char> skew_vision_cache;
+        mutable los_cache skew_vision_cache;
+
+        /**
+         * Scratch space for shadowcasting the sight of one observer in batched sees().
+         */
+        struct sight_buffer {
+            float seen[MAPSIZE_X][MAPSIZE_Y];
+        };
+        mutable std::unique_ptr<sight_buffer> batch_sight_buffer;
 
         /**
          * Vehicle list doesn't change often, but is pretty expensive.
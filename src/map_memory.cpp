@@ -1,5 +1,7 @@
 #include "map_memory.h"
 
+#include <deque>
+
 #include "coordinate_conversions.h"
 #include "cuboid_rectangle.h"
 #include "debug.h"
@@ -10,7 +12,45 @@
 #include "translations.h"
 #include "map.h"
 #include "world.h"
-const memorized_terrain_tile mm_submap::default_tile { "", 0, 0 };
+
+// Ids are never removed, there aren't many different ones even in a long game.
+// A deque, so that references returned by memorized_tile_id::str() stay valid.
+struct interned_tile_ids {
+    std::deque<std::string> ids = { std::string() };
+    std::unordered_map<std::string, uint32_t> indices = { { std::string(), 0 } };
+};
+
+static interned_tile_ids &get_interned_tile_ids()
+{
+    static interned_tile_ids interned;
+    return interned;
+}
+
+memorized_tile_id::memorized_tile_id( const std::string &id )
+{
+    interned_tile_ids &interned = get_interned_tile_ids();
+    const auto emplaced = interned.indices.emplace( id, interned.ids.size() );
+    if( emplaced.second ) {
+        interned.ids.push_back( id );
+    }
+    index = emplaced.first->second;
+}
+
+const std::string &memorized_tile_id::str() const
+{
+    return get_interned_tile_ids().ids[index];
+}
+
+int memorized_tile_table::index_of( const memorized_tile_id &id )
+{
+    const auto emplaced = indices.emplace( id.to_i(), table.size() );
+    if( emplaced.second ) {
+        table.push_back( id );
+    }
+    return emplaced.first->second;
+}
+
+const memorized_terrain_tile mm_submap::default_tile { memorized_tile_id(), 0, 0 };
 const int mm_submap::default_symbol = 0;
 
 #define MM_SIZE (MAPSIZE * 2)
@@ -83,7 +123,7 @@ void map_memory::memorize_tile( const tripoint &pos, const std::string &ter,
 {
     coord_pair p( pos );
     mm_submap &sm = get_submap( p.sm );
-    sm.set_tile( p.loc, memorized_terrain_tile{ ter, subtile, rotation } );
+    sm.set_tile( p.loc, memorized_terrain_tile{ memorized_tile_id( ter ), subtile, rotation } );
 }
 
 int map_memory::get_symbol( const tripoint &pos )
@@ -199,6 +239,7 @@ shared_ptr_fast<mm_submap> map_memory::find_submap( const tripoint &sm_pos )
 //FIXME: This is to fix old (mid 2022) saves. It can be removed at some point.
 static void temp_remove_open_air( const shared_ptr_fast<mm_submap> &sm )
 {
+    static const memorized_tile_id open_air( "t_open_air" );
 
     if( sm->is_empty() ) {
         return;
@@ -207,7 +248,7 @@ static void temp_remove_open_air( const shared_ptr_fast<mm_submap> &sm )
         for( int y = 0; y < SEEY; y++ ) {
             const memorized_terrain_tile &t = sm->tile( {x, y} );
 
-            if( !t.tile.empty() && t.tile == "t_open_air" ) {
+            if( t.tile == open_air ) {
                 sm->set_tile( {x, y}, mm_submap::default_tile );
             }
         }
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstdint>
 #include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "game_constants.h"
 #include "memory_fast.h"
@@ -10,8 +13,52 @@
 class JsonOut;
 class JsonIn;
 
+/**
+ * Id of a memorized tile, interned because memory holds lots of tiles but few different ids.
+ * The indices are only valid while the game runs, saves use @ref memorized_tile_table instead.
+ */
+class memorized_tile_id
+{
+    public:
+        /** The empty id, for tiles that aren't memorized. */
+        memorized_tile_id() = default;
+        explicit memorized_tile_id( const std::string &id );
+
+        const std::string &str() const;
+        bool empty() const {
+            return index == 0;
+        }
+        uint32_t to_i() const {
+            return index;
+        }
+
+        bool operator==( const memorized_tile_id &rhs ) const {
+            return index == rhs.index;
+        }
+        bool operator!=( const memorized_tile_id &rhs ) const {
+            return index != rhs.index;
+        }
+
+    private:
+        uint32_t index = 0;
+};
+
+/** Numbers the tile ids used in a saved region, so each id is written only once. */
+class memorized_tile_table
+{
+    public:
+        int index_of( const memorized_tile_id &id );
+        const std::vector<memorized_tile_id> &ids() const {
+            return table;
+        }
+
+    private:
+        std::vector<memorized_tile_id> table;
+        std::unordered_map<uint32_t, int> indices;
+};
+
 struct memorized_terrain_tile {
-    std::string tile;
+    memorized_tile_id tile;
     int subtile;
     int rotation;
 
@@ -72,8 +119,10 @@ struct mm_submap {
             symbols[p.y * SEEX + p.x] = value;
         }
 
-        void serialize( JsonOut &jsout ) const;
-        void deserialize( JsonIn &jsin );
+        /** Tile ids are written as indices into `table`, which the caller saves. */
+        void serialize( JsonOut &jsout, memorized_tile_table &table ) const;
+        /** `table` is empty for saves from before tile ids were numbered. */
+        void deserialize( JsonIn &jsin, const std::vector<memorized_tile_id> &table );
 
     private:
         std::vector<memorized_terrain_tile> tiles; // holds either 0 or SEEX*SEEY elements
@@ -93,6 +142,7 @@ struct mm_region {
 
     bool is_empty() const;
 
+    /** Written as the submaps and a table of the tile ids they use, see @ref mm_submap::serialize. */
     void serialize( JsonOut &jsout ) const;
     void deserialize( JsonIn &jsin );
 };
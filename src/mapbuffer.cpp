@@ -2,12 +2,23 @@
 
 #include <algorithm>
 #include <exception>
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <future>
+#include <istream>
+#include <iterator>
+#include <optional>
 #include <set>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "binary_io.h"
 #include "cata_utility.h"
 #include "coordinate_conversions.h"
 #include "debug.h"
@@ -18,6 +29,7 @@
 #include "game_constants.h"
 #include "json.h"
 #include "map.h"
+#include "options.h"
 #include "output.h"
 #include "popup.h"
 #include "string_formatter.h"
@@ -26,14 +38,29 @@
 #include "ui_manager.h"
 #include "world.h"
 
+#define dbg(x) DebugLog((x),DC::Map)
+
 mapbuffer MAPBUFFER;
 
+// Binary quads start with this, JSON ones can't
+static constexpr std::string_view binary_quad_magic = "BNSM";
+static constexpr uint64_t binary_quad_version = 1;
+
 mapbuffer::mapbuffer() = default;
 mapbuffer::~mapbuffer() = default;
 
 void mapbuffer::clear()
 {
+    // Evicted since the last save, so the game is being abandoned
+    if( !evicted.empty() && g != nullptr && g->get_active_world() != nullptr ) {
+        g->get_active_world()->discard_evicted_map_quads();
+    }
     submaps.clear();
+    prefetched.clear();
+    evicted.clear();
+    quad_last_used.clear();
+    lookups = 0;
+    stats = mapbuffer_stats();
 }
 
 bool mapbuffer::add_submap( const tripoint &p, std::unique_ptr<submap> &sm )
@@ -43,6 +70,7 @@ bool mapbuffer::add_submap( const tripoint &p, std::unique_ptr<submap> &sm )
     }
 
     submaps[p] = std::move( sm );
+    touch_quad( p );
 
     return true;
 }
@@ -67,12 +95,20 @@ void mapbuffer::remove_submap( tripoint addr )
         return;
     }
     submaps.erase( m_target );
+    quad_last_used.erase( sm_to_omt_copy( addr ) );
+}
+
+void mapbuffer::touch_quad( const tripoint &submap_addr )
+{
+    quad_last_used[sm_to_omt_copy( submap_addr )] = ++lookups;
 }
 
 submap *mapbuffer::lookup_submap( const tripoint &p )
 {
     const auto iter = submaps.find( p );
-    if( iter == submaps.end() ) {
+    if( iter != submaps.end() ) {
+        touch_quad( p );
+    } else {
         try {
             return unserialize_submaps( p );
         } catch( const std::exception &err ) {
@@ -95,13 +131,19 @@ void mapbuffer::save( bool delete_after_save )
 
     static_popup popup;
 
-    // A set of already-saved submaps, in global overmap coordinates.
-    std::set<tripoint> saved_submaps;
+    // Whatever the coordinates of a submap are, we're saving a 2x2 quad of submaps at a time.
+    // Submaps are generated in quads, so we know if we have one member of a quad,
+    // we have the rest of it, if that assumption is broken we have REAL problems.
+    // Ordered, so the save doesn't depend on how the submaps happen to be hashed.
+    std::set<tripoint> quads;
+    for( const auto &elem : submaps ) {
+        quads.insert( sm_to_omt_copy( elem.first ) );
+    }
     std::list<tripoint> submaps_to_delete;
     static constexpr std::chrono::milliseconds update_interval( 500 );
     auto last_update = std::chrono::steady_clock::now();
 
-    for( auto &elem : submaps ) {
+    for( const tripoint &om_addr : quads ) {
         auto now = std::chrono::steady_clock::now();
         if( last_update + update_interval < now ) {
             popup.message( _( "Please wait as the map saves [%d/%d]" ),
@@ -111,17 +153,6 @@ void mapbuffer::save( bool delete_after_save )
             inp_mngr.pump_events();
             last_update = now;
         }
-        // Whatever the coordinates of the current submap are,
-        // we're saving a 2x2 quad of submaps at a time.
-        // Submaps are generated in quads, so we know if we have one member of a quad,
-        // we have the rest of it, if that assumption is broken we have REAL problems.
-        const tripoint om_addr = sm_to_omt_copy( elem.first );
-        if( saved_submaps.contains( om_addr ) ) {
-            // Already handled this one.
-            continue;
-        }
-        saved_submaps.insert( om_addr );
-
         // A segment is a chunk of 32x32 submap quads.
         // We're breaking them into subdirectories so there aren't too many files per directory.
         // Might want to make a set for this one too so it's only checked once per save().
@@ -140,12 +171,107 @@ void mapbuffer::save( bool delete_after_save )
         remove_submap( elem );
     }
 
+    // Quads evicted since the last save are on disk already, but not part of the save yet
+    if( !disable_mapgen && !evicted.empty() ) {
+        g->get_active_world()->save_evicted_map_quads();
+        evicted.clear();
+    }
+
     get_distribution_grid_tracker().on_saved();
 }
 
+void mapbuffer::evict_cold_submaps( size_t budget_bytes, const inclusive_cuboid<tripoint> &keep )
+{
+    // Items, vehicles etc. aren't counted, but a submap is large even without them.
+    // Submaps sharing the tiles of uniform submaps are small enough to be ignored.
+    const size_t max_resident = budget_bytes / ( sizeof( submap ) + submap::tile_storage_bytes() );
+    size_t resident = std::ranges::count_if( submaps, []( const auto & elem ) {
+        return elem.second && !elem.second->shares_tiles();
+    } );
+    if( resident <= max_resident ) {
+        return;
+    }
+
+    std::vector<std::pair<uint64_t, tripoint>> candidates;
+    std::unordered_set<tripoint> seen;
+    for( const auto &elem : submaps ) {
+        const tripoint om_addr = sm_to_omt_copy( elem.first );
+        if( !seen.insert( om_addr ).second ) {
+            continue;
+        }
+        // Any of the 2x2 submaps being in `keep` keeps the whole quad
+        const tripoint sm_addr = omt_to_sm_copy( om_addr );
+        if( sm_addr.x + 1 >= keep.p_min.x && sm_addr.x <= keep.p_max.x &&
+            sm_addr.y + 1 >= keep.p_min.y && sm_addr.y <= keep.p_max.y &&
+            sm_addr.z >= keep.p_min.z && sm_addr.z <= keep.p_max.z ) {
+            continue;
+        }
+        const auto last_used = quad_last_used.find( om_addr );
+        candidates.emplace_back( last_used == quad_last_used.end() ? 0 : last_used->second, om_addr );
+    }
+    std::sort( candidates.begin(), candidates.end() );
+
+    const uint64_t evicted_before = stats.evicted;
+    for( const std::pair<uint64_t, tripoint> &candidate : candidates ) {
+        if( resident <= max_resident ) {
+            break;
+        }
+        resident -= evict_quad( candidate.second );
+    }
+    dbg( DL::Info ) << "Evicted " << stats.evicted - evicted_before << " submaps, "
+                    << submaps.size() << " remain in memory, " << evicted.size()
+                    << " quads evicted since the last save";
+}
+
+size_t mapbuffer::evict_quad( const tripoint &om_addr )
+{
+    const tripoint sm_addr = omt_to_sm_copy( om_addr );
+    const std::vector<tripoint> submap_addrs = {
+        sm_addr, sm_addr + point_south, sm_addr + point_east, sm_addr + point_south_east
+    };
+
+    bool all_uniform = true;
+    size_t own_tiles = 0;
+    for( const tripoint &submap_addr : submap_addrs ) {
+        const auto iter = submaps.find( submap_addr );
+        if( iter == submaps.end() || !iter->second ) {
+            continue;
+        }
+        all_uniform &= iter->second->is_uniform;
+        own_tiles += !iter->second->shares_tiles();
+    }
+    // Uniform quads are regenerated instead, like when saving
+    if( !all_uniform ) {
+        if( !g->get_active_world()->write_evicted_map_quad( om_addr, serialize_quad( submap_addrs ) ) ) {
+            // Keep it rather than lose it, the next quad may fare better
+            return 0;
+        }
+        evicted.insert( om_addr );
+    }
+
+    for( const tripoint &submap_addr : submap_addrs ) {
+        if( submaps.erase( submap_addr ) ) {
+            stats.evicted++;
+        }
+    }
+    quad_last_used.erase( om_addr );
+    prefetched.erase( om_addr );
+    return own_tiles;
+}
+
+mapbuffer_stats mapbuffer::get_stats() const
+{
+    mapbuffer_stats result = stats;
+    result.resident = submaps.size();
+    return result;
+}
+
 void mapbuffer::save_quad( const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
                            bool delete_after_save )
 {
+    // Whatever was prefetched is older than what's being saved
+    prefetched.erase( om_addr );
+
     std::vector<point> offsets;
     std::vector<tripoint> submap_addrs;
     offsets.push_back( point_zero );
@@ -159,8 +285,8 @@ void mapbuffer::save_quad( const tripoint &om_addr, std::list<tripoint> &submaps
         submap_addr.x += offsets_offset.x;
         submap_addr.y += offsets_offset.y;
         submap_addrs.push_back( submap_addr );
-        submap *sm = submaps[submap_addr].get();
-        if( sm != nullptr && !sm->is_uniform ) {
+        const auto iter = submaps.find( submap_addr );
+        if( iter != submaps.end() && iter->second && !iter->second->is_uniform ) {
             all_uniform = false;
         }
     }
@@ -169,7 +295,8 @@ void mapbuffer::save_quad( const tripoint &om_addr, std::list<tripoint> &submaps
         // Nothing to save - this quad will be regenerated faster than it would be re-read
         if( delete_after_save ) {
             for( auto &submap_addr : submap_addrs ) {
-                if( submaps.contains( submap_addr ) && submaps[submap_addr] != nullptr ) {
+                const auto iter = submaps.find( submap_addr );
+                if( iter != submaps.end() && iter->second != nullptr ) {
                     submaps_to_delete.push_back( submap_addr );
                 }
             }
@@ -182,19 +309,31 @@ void mapbuffer::save_quad( const tripoint &om_addr, std::list<tripoint> &submaps
         return;
     }
 
+    if( get_option<bool>( "BINARY_SUBMAPS" ) ) {
+        g->get_active_world()->write_map_quad( om_addr, [&]( std::ostream & fout ) {
+            const std::string data = serialize_quad( submap_addrs );
+            fout.write( data.data(), data.size() );
+            if( delete_after_save ) {
+                for( auto &submap_addr : submap_addrs ) {
+                    const auto iter = submaps.find( submap_addr );
+                    if( iter != submaps.end() && iter->second != nullptr ) {
+                        submaps_to_delete.push_back( submap_addr );
+                    }
+                }
+            }
+        } );
+        return;
+    }
+
     g->get_active_world()->write_map_quad( om_addr, [&]( std::ostream & fout ) {
         JsonOut jsout( fout );
         jsout.start_array();
         for( auto &submap_addr : submap_addrs ) {
-            if( !submaps.contains( submap_addr ) ) {
-                continue;
-            }
-
-            submap *sm = submaps[submap_addr].get();
-
-            if( sm == nullptr ) {
+            const auto iter = submaps.find( submap_addr );
+            if( iter == submaps.end() || iter->second == nullptr ) {
                 continue;
             }
+            submap *sm = iter->second.get();
 
             jsout.start_object();
 
@@ -227,9 +366,44 @@ submap *mapbuffer::unserialize_submaps( const tripoint &p )
     // Map the tripoint to the submap quad that stores it.
     const tripoint om_addr = sm_to_omt_copy( p );
 
-    using namespace std::placeholders;
-    if( !g->get_active_world()->read_map_quad( om_addr, std::bind( &mapbuffer::deserialize,
-            this, _1 ) ) ) {
+    bool read = false;
+    bool exists = false;
+    if( evicted.erase( om_addr ) ) {
+        const std::optional<std::string> data = g->get_active_world()->take_evicted_map_quad( om_addr );
+        if( data ) {
+            const size_t resident_before = submaps.size();
+            deserialize_binary( *data );
+            stats.reloaded += submaps.size() - resident_before;
+            read = true;
+            exists = true;
+        } else {
+            debugmsg( "Evicted map quad %s is gone, loading the last saved one", om_addr.to_string() );
+        }
+    }
+    auto staged = prefetched.find( om_addr );
+    if( !read && staged != prefetched.end() ) {
+        std::shared_future<std::optional<std::string>> pending = std::move( staged->second );
+        prefetched.erase( staged );
+        std::optional<std::string> data;
+        try {
+            data = pending.get();
+            read = true;
+        } catch( const std::exception & ) {
+            // Read it again below, which reports the error if it wasn't a fluke
+        }
+        if( data ) {
+            deserialize_quad( *data, om_addr );
+            exists = true;
+        }
+    }
+    if( !read ) {
+        exists = g->get_active_world()->read_map_quad( om_addr, [&]( std::istream & fin ) {
+            const std::string data( ( std::istreambuf_iterator<char>( fin ) ),
+                                    std::istreambuf_iterator<char>() );
+            deserialize_quad( data, om_addr );
+        } );
+    }
+    if( !exists ) {
         // If it doesn't exist, trigger generating it.
         return nullptr;
     }
@@ -241,6 +415,111 @@ submap *mapbuffer::unserialize_submaps( const tripoint &p )
     return submaps[ p ].get();
 }
 
+void mapbuffer::prefetch( const std::vector<tripoint> &submap_addrs )
+{
+    std::set<tripoint> wanted;
+    for( const tripoint &p : submap_addrs ) {
+        if( submaps.contains( p ) ) {
+            continue;
+        }
+        const tripoint om_addr = sm_to_omt_copy( p );
+        if( !wanted.insert( om_addr ).second || prefetched.contains( om_addr ) ||
+            evicted.contains( om_addr ) ) {
+            continue;
+        }
+        std::future<std::optional<std::string>> pending =
+            g->get_active_world()->prefetch_map_quad( om_addr );
+        if( !pending.valid() ) {
+            return;
+        }
+        prefetched.emplace( om_addr, pending.share() );
+    }
+    // Prefetched for another direction, reading it again if needed is cheaper than holding onto it
+    std::erase_if( prefetched, [&]( const auto & pr ) {
+        return !wanted.contains( pr.first );
+    } );
+}
+
+std::vector<tripoint> mapbuffer::ungenerated_quads( const std::vector<tripoint> &submap_addrs ) const
+{
+    std::vector<tripoint> result;
+    for( const tripoint &p : submap_addrs ) {
+        if( submaps.contains( p ) ) {
+            continue;
+        }
+        const tripoint om_addr = sm_to_omt_copy( p );
+        const auto iter = prefetched.find( om_addr );
+        if( iter == prefetched.end() ||
+            iter->second.wait_for( std::chrono::seconds( 0 ) ) != std::future_status::ready ) {
+            continue;
+        }
+        // Only peeking, failed reads are left to unserialize_submaps to report
+        try {
+            if( !iter->second.get().has_value() &&
+                std::ranges::find( result, om_addr ) == result.end() ) {
+                result.push_back( om_addr );
+            }
+        } catch( const std::exception & ) {
+            continue;
+        }
+    }
+    return result;
+}
+
+std::string mapbuffer::serialize_quad( const std::vector<tripoint> &submap_addrs ) const
+{
+    std::string data;
+    cata::binary_writer out( data );
+    out.write_raw( binary_quad_magic );
+    out.write_varint( binary_quad_version );
+    for( const tripoint &submap_addr : submap_addrs ) {
+        const auto iter = submaps.find( submap_addr );
+        if( iter == submaps.end() || iter->second == nullptr ) {
+            continue;
+        }
+        out.write_varint( savegame_version );
+        out.write_signed( submap_addr.x );
+        out.write_signed( submap_addr.y );
+        out.write_signed( submap_addr.z );
+        iter->second->store_binary( out );
+    }
+    return data;
+}
+
+void mapbuffer::deserialize_quad( std::string_view data, const tripoint &om_addr )
+{
+    if( data.starts_with( binary_quad_magic ) ) {
+        deserialize_binary( data );
+    } else {
+        JsonIn jsin( data, string_format( "map quad %s", om_addr.to_string() ) );
+        deserialize( jsin );
+    }
+}
+
+void mapbuffer::deserialize_binary( std::string_view data )
+{
+    cata::binary_reader in( data );
+    in.read_raw( binary_quad_magic.size() );
+    const uint64_t format = in.read_varint();
+    if( format != binary_quad_version ) {
+        throw std::runtime_error( string_format( "Unknown binary map quad version %d", format ) );
+    }
+    while( !in.at_end() ) {
+        const int version = in.read_varint();
+        tripoint submap_coordinates;
+        submap_coordinates.x = in.read_signed();
+        submap_coordinates.y = in.read_signed();
+        submap_coordinates.z = in.read_signed();
+        std::unique_ptr<submap> sm = std::make_unique<submap>( sm_to_ms_copy( submap_coordinates ) );
+        sm->load_binary( in, version, multiply_xy( submap_coordinates, 12 ) );
+
+        if( !add_submap( submap_coordinates, sm ) ) {
+            debugmsg( "submap %d,%d,%d was already loaded", submap_coordinates.x, submap_coordinates.y,
+                      submap_coordinates.z );
+        }
+    }
+}
+
 void mapbuffer::deserialize( JsonIn &jsin )
 {
     jsin.start_array();
@@ -1,16 +1,34 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <future>
 #include <list>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "coordinates.h"
+#include "cuboid_rectangle.h"
 #include "point.h"
 
 class submap;
 class JsonIn;
 
+struct mapbuffer_stats {
+    /** Submaps currently in memory. */
+    size_t resident = 0;
+    /** Submaps written to disk to stay within the memory budget, since the mapbuffer was last cleared. */
+    uint64_t evicted = 0;
+    /** Evicted submaps that were needed again. */
+    uint64_t reloaded = 0;
+};
+
 /**
  * Store, buffer, save and load the entire world map.
  */
@@ -56,8 +74,18 @@ class mapbuffer
             return lookup_submap( p.raw() );
         }
 
+        /**
+         * If the submaps take more than roughly `budget_bytes`, write the least recently used quads
+         * that don't overlap `keep` to disk and drop them, until they don't. Evicted quads are
+         * loaded again by @ref lookup_submap, and become part of the save with the next @ref save.
+         * Only call this when nothing outside `keep` is holding onto a submap, e.g. a tinymap.
+         */
+        void evict_cold_submaps( size_t budget_bytes, const inclusive_cuboid<tripoint> &keep );
+
+        mapbuffer_stats get_stats() const;
+
     private:
-        using submap_map_t = std::map<tripoint, std::unique_ptr<submap>>;
+        using submap_map_t = std::unordered_map<tripoint, std::unique_ptr<submap>>;
 
     public:
         submap_map_t::iterator begin() {
@@ -71,15 +99,43 @@ class mapbuffer
             return submaps.contains( p );
         }
 
+        /**
+         * Start reading the quads of these submaps on a separate thread, so @ref lookup_submap
+         * only has to deserialize them. Quads that were prefetched before, but aren't in
+         * `submap_addrs` any more, are dropped.
+         * Quads that were never saved are still generated by @ref lookup_submap.
+         */
+        void prefetch( const std::vector<tripoint> &submap_addrs );
+        /**
+         * Quads (in overmap terrain coordinates) of these submaps that were prefetched and turned
+         * out to never have been saved, so they have to be generated.
+         * Quads still being read aren't known yet and aren't included.
+         */
+        std::vector<tripoint> ungenerated_quads( const std::vector<tripoint> &submap_addrs ) const;
+
     private:
         // There's a very good reason this is private,
         // if not handled carefully, this can erase in-use submaps and crash the game.
         void remove_submap( tripoint addr );
         submap *unserialize_submaps( const tripoint &p );
         void deserialize( JsonIn &jsin );
+        void deserialize_binary( std::string_view data );
+        void deserialize_quad( std::string_view data, const tripoint &om_addr );
+        std::string serialize_quad( const std::vector<tripoint> &submap_addrs ) const;
+        void touch_quad( const tripoint &submap_addr );
+        /** @returns how many of the evicted submaps didn't share their tiles. */
+        size_t evict_quad( const tripoint &om_addr );
         void save_quad( const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
                         bool delete_after_save );
         submap_map_t submaps;
+        /** Raw contents of quads being read ahead, by quad address. */
+        std::map<tripoint, std::shared_future<std::optional<std::string>>> prefetched;
+        /** Quads evicted to the world's staging area since the last save. */
+        std::unordered_set<tripoint> evicted;
+        /** When each quad was last looked up, in lookups since the mapbuffer was cleared. */
+        std::unordered_map<tripoint, uint64_t> quad_last_used;
+        uint64_t lookups = 0;
+        mapbuffer_stats stats;
 };
 
 extern mapbuffer MAPBUFFER;
@@ -3451,9 +3451,9 @@ void mapgen_function_json_base::setup_common()
         debugmsg( "null json source location path" );
         return;
     }
-    shared_ptr_fast<std::istream> stream = DynamicDataLoader::get_instance().get_cached_stream(
-            *jsrcloc->path );
-    JsonIn jsin( *stream, *jsrcloc );
+    shared_ptr_fast<const std::string> contents = DynamicDataLoader::get_instance().get_cached_file(
+                *jsrcloc->path );
+    JsonIn jsin( *contents, *jsrcloc );
     JsonObject jo = jsin.get_object();
     mapgen_defer::defer = false;
     if( !setup_common( jo ) ) {
@@ -6,11 +6,14 @@
 #include <cfloat>
 #include <cmath>
 #include <cstdlib>
+#include <functional>
 #include <iterator>
 #include <list>
 #include <memory>
+#include <optional>
 #include <ostream>
 #include <unordered_map>
+#include <vector>
 
 #include "avatar.h"
 #include "behavior.h"
@@ -403,13 +406,22 @@ void monster::plan()
             }
         }
     } else if( friendly != 0 && !docile && !waiting ) {
+        std::vector<monster *> hostiles;
+        std::vector<tripoint> hostile_positions;
         for( monster &tmp : g->all_monsters() ) {
             if( tmp.friendly == 0 ) {
-                float rating = rate_target( tmp, dist, smart_planning );
-                if( rating < dist ) {
-                    target = &tmp;
-                    dist = rating;
-                }
+                hostiles.push_back( &tmp );
+                hostile_positions.push_back( tmp.pos() );
+            }
+        }
+        // Line of sight to all of them in one go, so rate_target only hits the cache
+        get_map().sees( { pos() }, hostile_positions,
+                        smart_planning ? MAX_VIEW_DISTANCE : max_sight_range );
+        for( monster *tmp : hostiles ) {
+            float rating = rate_target( *tmp, dist, smart_planning );
+            if( rating < dist ) {
+                target = tmp;
+                dist = rating;
             }
         }
     }
@@ -469,17 +481,30 @@ void monster::plan()
 
     fleeing = fleeing || ( mood == MATT_FLEE );
     if( friendly == 0 ) {
+        // Without smart planning, only monsters closer than the current best can change anything,
+        //  so those can be looked up by position instead of going through the whole faction
+        const bool nearby_only = !smart_planning && dist < FLT_MAX;
+        const int nearby_radius = nearby_only ? static_cast<int>( std::ceil( dist ) ) + 1 : 0;
         for( const auto &fac : factions ) {
             auto faction_att = faction.obj().attitude( fac.first );
             if( faction_att == MFA_NEUTRAL || faction_att == MFA_FRIENDLY ) {
                 continue;
             }
 
-            for( const weak_ptr_fast<monster> &weak : fac.second ) {
-                const shared_ptr_fast<monster> shared = weak.lock();
-                if( !shared ) {
-                    continue;
+            std::vector<shared_ptr_fast<monster>> candidates;
+            if( nearby_only ) {
+                candidates = g->critter_tracker->find_in_radius( pos(), nearby_radius, fac.first );
+                // Same order as the faction set, so ties are broken the same way
+                std::ranges::sort( candidates, std::less<>(), &shared_ptr_fast<monster>::get );
+            } else {
+                for( const weak_ptr_fast<monster> &weak : fac.second ) {
+                    if( shared_ptr_fast<monster> shared = weak.lock() ) {
+                        candidates.push_back( std::move( shared ) );
+                    }
                 }
+            }
+
+            for( const shared_ptr_fast<monster> &shared : candidates ) {
                 monster &mon = *shared;
                 float rating = rate_target( mon, dist, smart_planning );
                 if( rating == dist ) {
@@ -891,7 +916,25 @@ void monster::move()
     tripoint destination = this->pos();
 
     if( !this->is_wandering() ) {
-        if( this->repath_requested ) {
+        const bool use_flow_field = !get_option<bool>( "USE_LEGACY_PATHFINDING" ) &&
+                                    get_option<bool>( "PATHFINDING_FLOW_FIELD" );
+
+        if( use_flow_field ) {
+            // The field is shared with everyone chasing the same goal, so just read the next step off it
+            auto pair = this->get_pathfinding_pair();
+            const std::optional<tripoint> step = Pathfinding::next_step( this->pos(), this->goal,
+                                                 pair.first, pair.second );
+            if( step.has_value() ) {
+                // Rest of the path lives in the field
+                this->path = { *step };
+                if( *step != this->goal ) {
+                    this->path.push_back( this->goal );
+                }
+            } else {
+                // Goal can't be reached from here, the old path led to some previous goal
+                this->path.clear();
+            }
+        } else if( this->repath_requested ) {
             std::vector<tripoint> maybe_new_path;
 
             if( get_option<bool>( "USE_LEGACY_PATHFINDING" ) ) {
@@ -925,6 +968,8 @@ void monster::move()
 
             if( !is_viable_dest ) {
                 // Should not _usually_ occur, but...
+                // Our d_map may have missed a change to this tile, so make sure we don't get the same path again
+                Pathfinding::invalidate_d_maps( destination );
                 destination = this->pos();
                 this->path.clear();
                 this->repath_requested = true;
@@ -2786,7 +2786,10 @@ void monster::die( Creature *nkiller )
 
     if( anger_adjust != 0 || morale_adjust != 0 ) {
         int light = g->light_level( posz() );
-        for( monster &critter : g->all_monsters() ) {
+        // Anything further away than the light level can't see us anyway
+        const auto nearby = g->critter_tracker->find_in_radius( pos(), light );
+        for( const shared_ptr_fast<monster> &critter_ptr : nearby ) {
+            monster &critter = *critter_ptr;
             if( !critter.type->same_species( *type ) ) {
                 continue;
             }
@@ -3281,7 +3284,10 @@ void monster::on_hit( Creature *source, bodypart_id, dealt_projectile_attack con
 
     if( anger_adjust != 0 || morale_adjust != 0 ) {
         int light = g->light_level( posz() );
-        for( monster &critter : g->all_monsters() ) {
+        // Anything further away than the light level can't see us anyway
+        const auto nearby = g->critter_tracker->find_in_radius( pos(), light );
+        for( const shared_ptr_fast<monster> &critter_ptr : nearby ) {
+            monster &critter = *critter_ptr;
             if( !critter.type->same_species( *type ) ) {
                 continue;
             }
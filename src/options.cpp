@@ -1423,6 +1423,11 @@ void options_manager::add_options_general()
 
     get_option( "AUTOSAVE_MINUTES" ).setPrerequisite( "AUTOSAVE" );
 
+    add( "BACKGROUND_SAVE", general, translate_marker( "Save in background" ),
+         translate_marker( "If true, saving only serializes the game before play continues, compressing and writing it to disk happens on a separate thread.  Only applies to worlds using the SQLite save format." ),
+         true
+       );
+
     add_empty_line();
 
     add( "AUTO_NOTES", general, translate_marker( "Auto notes" ),
@@ -2323,6 +2328,52 @@ void options_manager::add_options_debug()
          translate_marker( "Use legacy pathfinding" ),
          translate_marker( "If true, opt out of new pathfinding in favor of legacy one. This makes pathfinding mods not work." ),
          false );
+
+    add( "PATHFINDING_CACHE_SIZE", debug,
+         translate_marker( "Pathfinding cache size" ),
+         translate_marker( "Maximum number of pathfinding maps kept between turns.  Each one takes about 200 KiB.  Lower values save memory at the cost of recalculating paths more often." ),
+         0, 1024, 64 );
+
+    add( "PATHFINDING_HIERARCHICAL", debug,
+         translate_marker( "Hierarchical pathfinding" ),
+         translate_marker( "If true, long routes are first planned submap by submap over a graph of submap entrances, stairs and ramps, and only then refined tile by tile.  Much faster for long routes, but routes may be slightly longer than optimal." ),
+         false );
+
+    add( "PARALLEL_MAP_CACHE", debug,
+         translate_marker( "Parallel map cache building" ),
+         translate_marker( "If true, transparency, outside and floor caches of all z-levels are built on multiple threads.  Disable to debug issues with map caches." ),
+         true );
+
+    add( "PATHFINDING_FLOW_FIELD", debug,
+         translate_marker( "Flow field pathfinding" ),
+         translate_marker( "If true, monsters chasing the same target share a single field and only look up their next step each turn instead of planning whole routes.  Much faster for hordes." ),
+         false );
+
+    add( "MAP_PREFETCH", debug,
+         translate_marker( "Map prefetching" ),
+         translate_marker( "If true, saved map data the player is moving towards is read on a separate thread before it's needed.  Only applies to worlds using the SQLite save format." ),
+         true );
+
+    add( "MAP_PREGENERATE", debug,
+         translate_marker( "Map pregeneration" ),
+         translate_marker( "If true, map the player is moving towards which was never visited is generated a bit every turn, instead of all at once when it's needed.  Requires map prefetching." ),
+         false );
+
+    add( "MAP_MEMORY_BUDGET", debug,
+         translate_marker( "Map memory budget" ),
+         translate_marker( "Approximate memory, in megabytes, that map data away from the player may take before the least recently visited areas are written to disk and dropped from memory.  They become part of the save with the next save.  0 for no limit." ),
+         0, 65536, 0
+       );
+
+    add( "SKIP_VERIFIED_DATA_CHECKS", debug,
+         translate_marker( "Skip repeated data checks" ),
+         translate_marker( "If true, consistency checks of the game data are skipped when the same data in the same order already passed them with this version of the game.  Doesn't apply when mods with Lua scripts are loaded, nor to builds with uncommitted changes." ),
+         false );
+
+    add( "BINARY_SUBMAPS", debug,
+         translate_marker( "Binary map saves" ),
+         translate_marker( "If true, map data is saved in a compact binary format that is faster to load.  If false, it is saved as JSON, which is easier to inspect.  Both can always be loaded." ),
+         true );
 }
 
 void options_manager::add_options_world_default()
@@ -6185,6 +6185,10 @@ void overmap::open( overmap_special_batch &enabled_specials )
             pointers.push_back( overmap_buffer.get_existing( loc + point( i, 0 ) ) );
         }
 
+        // Only depends on the location and neighbors, not on which overmaps were generated before
+        // or on which thread
+        const scoped_rng_seed seed( rng_location_seed( g->get_seed(), rng_seed_domain::overmap,
+                                    tripoint( loc.raw(), 0 ) ) );
         // pointers looks like (north, south, west, east)
         generate( pointers[0], pointers[3], pointers[1], pointers[2], enabled_specials );
     }
@@ -117,34 +117,69 @@ void overmapbuffer::create_custom_overmap( const point_abs_om &p, overmap_specia
     new_om->populate( specials );
 }
 
+std::vector<std::vector<point_abs_om>> overmapbuffer::generation_waves(
+                                        const std::vector<point_abs_om> &locs )
+{
+    std::vector<point_abs_om> sorted = locs;
+    std::sort( sorted.begin(), sorted.end() );
+    sorted.erase( std::unique( sorted.begin(), sorted.end() ), sorted.end() );
+
+    // Sorted by x, then y, so the west and north neighbors come before an overmap. It goes into
+    // the wave after the later one of them, if they are generated at all.
+    std::map<point_abs_om, size_t> wave_of;
+    std::vector<std::vector<point_abs_om>> waves;
+    for( const point_abs_om &loc : sorted ) {
+        size_t wave = 0;
+        for( const point &offset : {
+                 point_west, point_north
+             } ) {
+            const auto neighbor = wave_of.find( loc + offset );
+            if( neighbor != wave_of.end() ) {
+                wave = std::max( wave, neighbor->second + 1 );
+            }
+        }
+        wave_of.emplace( loc, wave );
+        if( waves.size() <= wave ) {
+            waves.resize( wave + 1 );
+        }
+        waves[wave].push_back( loc );
+    }
+    return waves;
+}
+
 void overmapbuffer::generate( const std::vector<point_abs_om> &locs )
 {
     using overmap_loc = std::pair<point_abs_om, std::unique_ptr<overmap>>;
 
-    std::vector<std::future<overmap_loc>> async_data;
-    for( auto &loc : locs ) {
-        if( overmap_buffer.has( loc ) ) {
-            continue;
+    std::vector<point_abs_om> missing;
+    for( const point_abs_om &loc : locs ) {
+        if( !overmap_buffer.has( loc ) ) {
+            missing.push_back( loc );
         }
-
-        auto gen_func = [&]() {
-            auto map = std::make_unique<overmap>( loc );
-            map->populate();
-            fix_mongroups( *map );
-            fix_npcs( *map );
-            return std::make_pair( loc, std::move( map ) );
-        };
-        async_data.push_back( std::async( std::launch::async, gen_func ) );
     }
 
     auto popup = make_shared_fast<throbber_popup>( _( "Please wait..." ) );
-    for( auto &f : async_data ) {
-        while( f.wait_for( std::chrono::milliseconds( 10 ) ) != std::future_status::ready ) {
-            popup->refresh();
+    // Overmaps build on their neighbors, so neighbors can't be generated at the same time.
+    // Each wave only has overmaps that aren't next to each other, and sees the previous waves.
+    for( const std::vector<point_abs_om> &wave : generation_waves( missing ) ) {
+        std::vector<std::future<overmap_loc>> async_data;
+        for( const point_abs_om &loc : wave ) {
+            auto gen_func = [this, loc]() {
+                auto map = std::make_unique<overmap>( loc );
+                map->populate();
+                fix_mongroups( *map );
+                fix_npcs( *map );
+                return std::make_pair( loc, std::move( map ) );
+            };
+            async_data.push_back( std::async( std::launch::async, gen_func ) );
+        }
+
+        for( auto &f : async_data ) {
+            while( f.wait_for( std::chrono::milliseconds( 10 ) ) != std::future_status::ready ) {
+                popup->refresh();
+            }
         }
-    }
 
-    {
         write_lock<std::shared_mutex> _l( mutex );
         for( auto &m : async_data ) {
             auto result = m.get();
@@ -172,9 +172,15 @@ class overmapbuffer
         void create_custom_overmap( const point_abs_om &, overmap_special_batch &specials );
 
         /**
-        * Generates overmap tiles, if missing
+        * Generates overmap tiles, if missing. Ones that aren't neighbors are generated in parallel.
         */
         void generate( const std::vector<point_abs_om> &locs );
+        /**
+         * Splits `locs` into batches that can be generated in parallel, in order. No batch has
+         * neighbors in it, and every overmap comes after its west and north neighbors.
+         */
+        static std::vector<std::vector<point_abs_om>> generation_waves(
+                    const std::vector<point_abs_om> &locs );
 
         /**
          * Returns the overmap terrain at the given OMT coordinates.
@@ -269,6 +269,10 @@ std::string PATH_INFO::user_sound()
 {
     return user_dir_value + "sound/";
 }
+std::string PATH_INFO::verified_data()
+{
+    return config_dir_value + "verified_data.bin";
+}
 std::string PATH_INFO::worldoptions()
 {
     return "worldoptions.json";
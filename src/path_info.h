@@ -43,6 +43,7 @@ std::string sokoban();
 std::string templatedir();
 std::string user_dir();
 std::string user_keybindings();
+std::string verified_data();
 std::string user_moddir();
 std::string worldoptions();
 std::string crash();
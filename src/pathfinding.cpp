@@ -6,9 +6,13 @@
 #include <queue>
 #include <vector>
 
+#include "cata_utility.h"
+#include "cuboid_rectangle.h"
 #include "game.h"
+#include "line.h"
 #include "map.h"
 #include "map_iterator.h"
+#include "options.h"
 #include "point.h"
 #include "submap.h"
 #include "trap.h"
@@ -28,8 +32,16 @@ static constexpr std::array<point, 8> DIRS_2D = {
     point_south,
 };
 
+// Routes shorter than this (in tiles) don't benefit from the portal graph
+static constexpr int HIERARCHICAL_MIN_DIST = SEEX * 2;
+// Submap border entrances at least this wide get a portal at both ends instead of one in the middle
+static constexpr int WIDE_ENTRANCE_SIZE = SEEX / 2;
+
 decltype( Pathfinding::d_maps_store ) Pathfinding::d_maps_store = {};
 decltype( Pathfinding::d_maps ) Pathfinding::d_maps = {};
+decltype( Pathfinding::d_maps_origin ) Pathfinding::d_maps_origin = {};
+decltype( Pathfinding::cache_stats ) Pathfinding::cache_stats = {};
+decltype( Pathfinding::portal_graphs ) Pathfinding::portal_graphs = {};
 decltype( Pathfinding::z_area ) Pathfinding::z_area = {};
 decltype( Pathfinding::z_caches ) Pathfinding::z_caches = {};
 decltype( Pathfinding::z_caches_open_air ) Pathfinding::z_caches_open_air = {};
@@ -47,6 +59,28 @@ static constexpr bool is_inf( float x )
     return x == INFINITY;
 }
 
+// Position of the submap containing local `p`, in local submap coords
+static tripoint sm_pos_of( const tripoint &p )
+{
+    return tripoint( p.x / SEEX, p.y / SEEY, p.z );
+}
+// Local position of the top left tile of submap at `sm_pos`
+static point sm_corner_of( const tripoint &sm_pos )
+{
+    return point( sm_pos.x * SEEX, sm_pos.y * SEEY );
+}
+// Index of local `p` in arrays covering submap at `sm_pos`
+static int sm_index_of( const tripoint &sm_pos, const point &p )
+{
+    const point rel = p - sm_corner_of( sm_pos );
+    return rel.y * SEEX + rel.x;
+}
+// Local position of tile at `index` of arrays covering submap at `sm_pos`
+static point sm_tile_at( const tripoint &sm_pos, const int index )
+{
+    return sm_corner_of( sm_pos ) + point( index % SEEX, index / SEEX );
+}
+
 // PathfindingSettings impls
 int PathfindingSettings::z_move_type() const
 {
@@ -197,20 +231,134 @@ void Pathfinding::produce_d_map( point dest, int z, PathfindingSettings settings
 
     Pathfinding::d_maps.push_back( std::move( d_map ) );
 }
+void Pathfinding::recycle_d_map( std::unique_ptr<Pathfinding> &&d_map )
+{
+    d_map->reset_maps();
+    d_map->reset_tile_state();
+    d_map->unbiased_frontier.clear();
+    d_map->forbidden_moves.clear();
+    d_map->domain = Pathfinding::MapDomain::RELATIVE_DOMAIN;
+    d_map->is_explored = false;
+    Pathfinding::d_maps_store.push_back( std::move( d_map ) );
+}
 void Pathfinding::clear_d_maps()
 {
     for( auto &map : Pathfinding::d_maps ) {
-        map->reset_maps();
-        map->reset_tile_state();
-        map->unbiased_frontier.clear();
-        map->forbidden_moves.clear();
-        map->domain = Pathfinding::MapDomain::RELATIVE_DOMAIN;
-        map->is_explored = false;
-        Pathfinding::d_maps_store.push_back( std::move( map ) );
+        Pathfinding::recycle_d_map( std::move( map ) );
     }
     Pathfinding::d_maps.clear();
+    Pathfinding::portal_graphs.clear();
     Pathfinding::cached_closest_z_changes.clear();
 }
+template<typename Pred>
+int Pathfinding::recycle_d_maps_if( Pred pred )
+{
+    int recycled = 0;
+    for( auto it = Pathfinding::d_maps.begin(); it != Pathfinding::d_maps.end(); ) {
+        if( pred( **it ) ) {
+            Pathfinding::recycle_d_map( std::move( *it ) );
+            it = Pathfinding::d_maps.erase( it );
+            recycled++;
+        } else {
+            ++it;
+        }
+    }
+    return recycled;
+}
+void Pathfinding::validate_d_maps_origin()
+{
+    const tripoint cur_origin = get_map().get_abs_sub();
+    if( cur_origin == Pathfinding::d_maps_origin ) {
+        return;
+    }
+
+    Pathfinding::cache_stats.invalidations += static_cast<int>( Pathfinding::d_maps.size() );
+    Pathfinding::clear_d_maps();
+    Pathfinding::d_maps_origin = cur_origin;
+}
+void Pathfinding::retire_d_maps()
+{
+    Pathfinding::validate_d_maps_origin();
+
+    Pathfinding::recycle_d_maps_if( []( const Pathfinding & map ) {
+        return Pathfinding::is_volatile( map.settings );
+    } );
+    std::erase_if( Pathfinding::portal_graphs, []( const std::unique_ptr<PortalGraph> &graph ) {
+        return Pathfinding::is_volatile( graph->settings );
+    } );
+
+    const size_t budget = std::max( get_option<int>( "PATHFINDING_CACHE_SIZE" ), 0 );
+    if( Pathfinding::d_maps.size() > budget ) {
+        // Least recently used maps are at the front
+        const auto evicted_end = Pathfinding::d_maps.begin() + ( Pathfinding::d_maps.size() - budget );
+        for( auto it = Pathfinding::d_maps.begin(); it != evicted_end; ++it ) {
+            Pathfinding::recycle_d_map( std::move( *it ) );
+        }
+        Pathfinding::cache_stats.evictions += static_cast<int>( Pathfinding::d_maps.size() - budget );
+        Pathfinding::d_maps.erase( Pathfinding::d_maps.begin(), evicted_end );
+    }
+
+    // Portal graphs are much smaller, one for each kind of pathfinder is plenty
+    if( Pathfinding::portal_graphs.size() > budget ) {
+        Pathfinding::portal_graphs.erase( Pathfinding::portal_graphs.begin(),
+                                          Pathfinding::portal_graphs.end() - budget );
+    }
+
+    // Spare maps count towards the budget too, they are just as large
+    const size_t spare_budget = budget - Pathfinding::d_maps.size();
+    if( Pathfinding::d_maps_store.size() > spare_budget ) {
+        Pathfinding::d_maps_store.resize( spare_budget );
+    }
+
+    // Z-level changes are cheap to recalculate, so don't bother tracking their validity
+    Pathfinding::cached_closest_z_changes.clear();
+}
+void Pathfinding::invalidate_d_maps( const int z )
+{
+    for( const std::unique_ptr<PortalGraph> &graph : Pathfinding::portal_graphs ) {
+        // Z-level changes connect us to adjacent levels as well
+        std::erase_if( graph->submaps, [z]( const auto & pair ) {
+            return std::abs( pair.first.z - z ) <= 1;
+        } );
+    }
+    Pathfinding::cache_stats.invalidations += Pathfinding::recycle_d_maps_if( [z](
+                Pathfinding & map ) {
+        return map.z == z;
+    } );
+}
+void Pathfinding::invalidate_d_maps( const tripoint &p )
+{
+    if( !get_map().inbounds( p ) ) {
+        return;
+    }
+
+    Pathfinding::invalidate_portals( p );
+    Pathfinding::cache_stats.invalidations += Pathfinding::recycle_d_maps_if( [&p](
+                Pathfinding & map ) {
+        return map.z == p.z && map.depends_on( p.xy() );
+    } );
+}
+bool Pathfinding::depends_on( const point &p )
+{
+    // Tiles which weren't reached yet will be calculated from scratch once they are.
+    // Relative searches keep g-values of tiles they have reset, so those count as well.
+    return p == this->dest ||
+           this->tile_state_at( p ) != State::UNVISITED ||
+           this->g_at( p ) != 0.0;
+}
+bool Pathfinding::is_volatile( const PathfindingSettings &settings )
+{
+    // Critters move around every turn without notifying us
+    return settings.mob_presence_penalty > 0;
+}
+const Pathfinding::CacheStats &Pathfinding::get_cache_stats()
+{
+    return Pathfinding::cache_stats;
+}
+void Pathfinding::reset_cache_stats()
+{
+    Pathfinding::cache_stats = CacheStats();
+}
 void Pathfinding::reset_maps()
 {
     this->p_at( this->dest ) = 0.0;
@@ -417,6 +565,156 @@ void Pathfinding::update_z_caches( bool update_open_air )
 
     Pathfinding::z_area = cur_z_area;
 }
+/// Pathfinding: costs
+bool Pathfinding::is_move_allowed( const tripoint &from, const tripoint &to,
+                                   const vehicle *from_vehicle, const vehicle *to_vehicle )
+{
+    const bool is_valid_to_step_into_veh =
+        from_vehicle == nullptr ?
+        true :
+        from_vehicle->allowed_move( from_vehicle->tripoint_to_mount( from ),
+                                    from_vehicle->tripoint_to_mount( to ) );
+
+    const bool is_valid_to_step_out_of_veh =
+        to_vehicle == nullptr ?
+        true :
+        to_vehicle->allowed_move( to_vehicle->tripoint_to_mount( from ),
+                                  to_vehicle->tripoint_to_mount( to ) );
+
+    return is_valid_to_step_into_veh && is_valid_to_step_out_of_veh;
+}
+float Pathfinding::calc_g( const PathfindingSettings &settings, const tripoint &p,
+                           const bool is_diag, const vehicle *p_vehicle, const int p_vehicle_part,
+                           const vehicle *next_vehicle )
+{
+    const map &here = get_map();
+
+    const bool can_open_doors = !is_inf( settings.door_open_cost );
+    const bool can_bash = settings.bash_strength_val > 0;
+    const bool can_climb = !is_inf( settings.climb_cost );
+    const bool care_about_mobs = settings.mob_presence_penalty > 0;
+    const bool care_about_traps = settings.trap_cost > 0;
+
+    const maptile &new_tile = here.maptile_at_internal( p );
+    const auto &terrain = new_tile.get_ter_t();
+    const auto &furniture = new_tile.get_furn_t();
+    const int move_cost = here.move_cost_internal( furniture, terrain, p_vehicle, p_vehicle_part );
+
+    float cur_g = is_diag ? 0.75 * move_cost : 0.5 * move_cost;
+    cur_g *= settings.move_cost_coeff;
+
+    // First, check for trivial cost modifiers
+    const bool is_rough = move_cost > 2;
+    const bool is_sharp = terrain.has_flag( TFLAG_SHARP );
+
+    cur_g += is_rough ? settings.rough_terrain_cost : 0.0;
+    cur_g += is_sharp ? settings.sharp_terrain_cost : 0.0;
+
+    if( care_about_mobs && !std::isinf( cur_g ) ) {
+        cur_g += g->critter_at( p, true ) != nullptr ?
+                 settings.mob_presence_penalty :
+                 0.0;
+    }
+
+    if( care_about_traps && !std::isinf( cur_g ) ) {
+        const trap &maybe_ter_trap = terrain.trap.obj();
+        const trap &maybe_trap = maybe_ter_trap.is_benign() ? new_tile.get_trap_t() : maybe_ter_trap;
+        const bool is_trap = !maybe_trap.is_benign();
+
+        cur_g += is_trap ? settings.trap_cost : 0.0;
+    }
+
+    const bool is_ledge = here.has_zlevels() && terrain.has_flag( TFLAG_NO_FLOOR );
+    if( is_ledge && !settings.can_fly ) {
+        // Close ledges outright for non-fliers
+        cur_g += INFINITY;
+    }
+
+    // And finally, add a potential field extra
+    if( !std::isinf( cur_g ) && settings.extra_g_costs.contains( p.xy() ) ) {
+        cur_g += settings.extra_g_costs.at( p.xy() );
+    }
+
+    const bool is_passable = move_cost != 0;
+    float obstacle_g = 0;
+    // Calculate the cost for if the tile is impassable
+    while( !std::isinf( cur_g ) && !is_passable ) {
+        const bool is_climbable = terrain.has_flag( TFLAG_CLIMBABLE );
+        const bool is_door = !!terrain.open || !!furniture.open;
+
+        if( p_vehicle != nullptr ) {
+            // Do processing for possible vehicle first
+            const auto vpobst = vpart_position( const_cast<vehicle &>( *p_vehicle ),
+                                                p_vehicle_part ).obstacle_at_part();
+            const int obstacle_part = vpobst ? vpobst->part_index() : -1;
+
+            if( obstacle_part >= 0 ) {
+                const bool part_is_door = p_vehicle->part_flag( obstacle_part, VPFLAG_OPENABLE );
+                const bool part_opens_from_inside = p_vehicle->part_flag( obstacle_part, "OPENCLOSE_INSIDE" );
+                const bool is_cur_point_inside = p_vehicle == next_vehicle;
+                const bool valid_to_open = part_is_door && ( part_opens_from_inside ? is_cur_point_inside : true );
+
+                if( can_open_doors && valid_to_open ) {
+                    obstacle_g = settings.door_open_cost;
+                } else if( can_bash ) {
+                    const int htd = p_vehicle->hits_to_destroy( obstacle_part,
+                                    settings.bash_strength_val * settings.bash_strength_quanta,
+                                    DT_BASH );
+                    if( htd == 0 ) {
+                        // We cannot bash down this part
+                        obstacle_g = INFINITY;
+                        break;
+                    } else {
+                        obstacle_g = settings.bash_cost * htd;
+                        break;
+                    }
+                } else {
+                    // Nothing can be done here. Don't bother with other checks since vehicles take priority.
+                    obstacle_g = INFINITY;
+                    break;
+                }
+            }
+        }
+
+        if( is_climbable && can_climb ) {
+            obstacle_g = settings.climb_cost;
+            break;
+        }
+        if( is_door && can_open_doors ) {
+            // Doors that can only be open from the inside
+            const bool door_opens_from_inside = terrain.has_flag( "OPENCLOSE_INSIDE" ) ||
+                                                furniture.has_flag( "OPENCLOSE_INSIDE" );
+            const bool is_cur_point_inside = !here.is_outside( p.xy() );
+            const bool valid_to_open = door_opens_from_inside ? is_cur_point_inside : true;
+            if( valid_to_open ) {
+                obstacle_g = settings.door_open_cost;
+                break;
+            }
+        }
+        if( can_bash ) {
+            // Time to consider bashing the obstacle
+            const int rating = here.bash_rating_internal(
+                                   settings.bash_strength_val * settings.bash_strength_quanta,
+                                   furniture, terrain, false, p_vehicle, p_vehicle_part );
+            if( rating > 1 ) {
+                obstacle_g = ( 10. / rating ) * settings.bash_cost;
+                break;
+            } else if( rating == 1 ) {
+                // Rating == 1 implies it will take at least 10 turns to take this down
+                //   which is a very unattractive target
+                //   so we'll penalize this target a lot
+                obstacle_g = 30.0 * settings.bash_cost * settings.bash_cost * settings.bash_cost;
+                break;
+            }
+
+        }
+        // We can do nothing anymore, close the tile
+        obstacle_g = INFINITY;
+        break;
+    }
+
+    return cur_g + obstacle_g;
+}
 /// Pathfinding: main loops
 void Pathfinding::detect_culled_frontier(
     const point &start, const RouteSettings &route_settings, std::unordered_set<point> &out )
@@ -528,11 +826,6 @@ Pathfinding::ExpansionOutcome Pathfinding::expand_2d_up_to(
     std::unordered_set<point> culled_frontier;
     ExpansionOutcome result = ExpansionOutcome::UNSET;
 
-    const bool can_open_doors = !is_inf( this->settings.door_open_cost );
-    const bool can_bash = this->settings.bash_strength_val > 0;
-    const bool can_climb = !is_inf( this->settings.climb_cost );
-    const bool care_about_mobs = this->settings.mob_presence_penalty > 0;
-    const bool care_about_traps = this->settings.trap_cost > 0;
     const map &here = get_map();
 
     while( !biased_frontier.empty() ) {
@@ -582,157 +875,20 @@ Pathfinding::ExpansionOutcome Pathfinding::expand_2d_up_to(
             const vehicle *cur_vehicle;
             cur_vehicle = here.veh_at_internal( cur_point_with_z, cur_vehicle_part );
 
-            {
-                bool is_move_valid = true;
-
-                const bool is_valid_to_step_into_veh =
-                    cur_vehicle == nullptr ?
-                    true :
-                    cur_vehicle->allowed_move( cur_vehicle->tripoint_to_mount( cur_point_with_z ),
-                                               cur_vehicle->tripoint_to_mount( next_point_with_z ) );
-
-                const bool is_valid_to_step_out_of_veh =
-                    next_vehicle == nullptr ?
-                    true :
-                    next_vehicle->allowed_move( next_vehicle->tripoint_to_mount( cur_point_with_z ),
-                                                next_vehicle->tripoint_to_mount( next_point_with_z ) );
-
-                is_move_valid &= is_valid_to_step_into_veh;
-                is_move_valid &= is_valid_to_step_out_of_veh;
-
-                if( !is_move_valid ) {
-                    this->forbidden_moves.emplace( cur_point, next_point );
-                    continue;
-                }
+            if( !Pathfinding::is_move_allowed( cur_point_with_z, next_point_with_z, cur_vehicle,
+                                               next_vehicle ) ) {
+                this->forbidden_moves.emplace( cur_point, next_point );
+                continue;
             }
 
-            const maptile &new_tile = here.maptile_at_internal( cur_point_with_z );
-            const auto &terrain = new_tile.get_ter_t();
-            const auto &furniture = new_tile.get_furn_t();
-            const int move_cost = here.move_cost_internal( furniture, terrain, cur_vehicle, cur_vehicle_part );
-
             float cur_g = this->g_at( cur_point );
             // May be false for relative search, so we'll reuse g-values there
             const bool is_g_calc_needed = cur_g == 0.0;
 
             if( is_g_calc_needed ) {
-                bool is_diag = dir.x != 0 && dir.y != 0;
-                cur_g += is_diag ? 0.75 * move_cost : 0.5 * move_cost;
-                cur_g *= this->settings.move_cost_coeff;
-
-                // First, check for trivial cost modifiers
-                const bool is_rough = move_cost > 2;
-                const bool is_sharp = terrain.has_flag( TFLAG_SHARP );
-
-                cur_g += is_rough ? this->settings.rough_terrain_cost : 0.0;
-                cur_g += is_sharp ? this->settings.sharp_terrain_cost : 0.0;
-
-                if( care_about_mobs && !std::isinf( cur_g ) ) {
-                    cur_g += g->critter_at( cur_point_with_z, true ) != nullptr ?
-                             this->settings.mob_presence_penalty :
-                             0.0;
-                }
-
-                if( care_about_traps && !std::isinf( cur_g ) ) {
-                    const trap &maybe_ter_trap = terrain.trap.obj();
-                    const trap &maybe_trap = maybe_ter_trap.is_benign() ? new_tile.get_trap_t() : maybe_ter_trap;
-                    const bool is_trap = !maybe_trap.is_benign();
-
-                    cur_g += is_trap ? this->settings.trap_cost : 0.0;
-                }
-
-                const bool is_ledge = here.has_zlevels() && terrain.has_flag( TFLAG_NO_FLOOR );
-                if( is_ledge && !this->settings.can_fly ) {
-                    // Close ledges outright for non-fliers
-                    cur_g += INFINITY;
-                }
-
-                // And finally, add a potential field extra
-                if( !std::isinf( cur_g ) && this->settings.extra_g_costs.contains( cur_point ) ) {
-                    cur_g += this->settings.extra_g_costs.at( cur_point );
-                }
-
-                const bool is_passable = move_cost != 0;
-                float obstacle_g = 0;
-                // Calculate the cost for if the tile is impassable
-                while( !std::isinf( cur_g ) && !is_passable ) {
-                    const bool is_climbable = terrain.has_flag( TFLAG_CLIMBABLE );
-                    const bool is_door = !!terrain.open || !!furniture.open;
-
-                    if( cur_vehicle != nullptr ) {
-                        // Do processing for possible vehicle first
-                        const auto vpobst = vpart_position( const_cast<vehicle &>( *cur_vehicle ),
-                                                            cur_vehicle_part ).obstacle_at_part();
-                        const int obstacle_part = vpobst ? vpobst->part_index() : -1;
-
-                        if( obstacle_part >= 0 ) {
-                            int _;
-                            const bool part_is_door = cur_vehicle->part_flag( obstacle_part, VPFLAG_OPENABLE );
-                            const bool part_opens_from_inside = cur_vehicle->part_flag( obstacle_part, "OPENCLOSE_INSIDE" );
-                            const bool is_cur_point_inside = here.veh_at_internal( cur_point_with_z, _ ) == next_vehicle;
-                            const bool valid_to_open = part_is_door && ( part_opens_from_inside ? is_cur_point_inside : true );
-
-                            if( can_open_doors && valid_to_open ) {
-                                obstacle_g = this->settings.door_open_cost;
-                            } else if( can_bash ) {
-                                const int htd = cur_vehicle->hits_to_destroy( obstacle_part,
-                                                this->settings.bash_strength_val * this->settings.bash_strength_quanta,
-                                                DT_BASH );
-                                if( htd == 0 ) {
-                                    // We cannot bash down this part
-                                    obstacle_g = INFINITY;
-                                    break;
-                                } else {
-                                    obstacle_g = this->settings.bash_cost * htd;
-                                    break;
-                                }
-                            } else {
-                                // Nothing can be done here. Don't bother with other checks since vehicles take priority.
-                                obstacle_g = INFINITY;
-                                break;
-                            }
-                        }
-                    }
-
-                    if( is_climbable && can_climb ) {
-                        obstacle_g = this->settings.climb_cost;
-                        break;
-                    }
-                    if( is_door && can_open_doors ) {
-                        // Doors that can only be open from the inside
-                        const bool door_opens_from_inside = terrain.has_flag( "OPENCLOSE_INSIDE" ) ||
-                                                            furniture.has_flag( "OPENCLOSE_INSIDE" );
-                        const bool is_cur_point_inside = !here.is_outside( cur_point );
-                        const bool valid_to_open = door_opens_from_inside ? is_cur_point_inside : true;
-                        if( valid_to_open ) {
-                            obstacle_g = this->settings.door_open_cost;
-                            break;
-                        }
-                    }
-                    if( can_bash ) {
-                        // Time to consider bashing the obstacle
-                        const int rating = here.bash_rating_internal(
-                                               this->settings.bash_strength_val * this->settings.bash_strength_quanta,
-                                               furniture, terrain, false, cur_vehicle, cur_vehicle_part );
-                        if( rating > 1 ) {
-                            obstacle_g = ( 10. / rating ) * this->settings.bash_cost;
-                            break;
-                        } else if( rating == 1 ) {
-                            // Rating == 1 implies it will take at least 10 turns to take this down
-                            //   which is a very unattractive target
-                            //   so we'll penalize this target a lot
-                            obstacle_g = 30.0 * this->settings.bash_cost * this->settings.bash_cost * this->settings.bash_cost;
-                            break;
-                        }
-
-                    }
-                    // We can do nothing anymore, close the tile
-                    obstacle_g = INFINITY;
-                    break;
-                }
-
-                cur_g += obstacle_g;
-
+                const bool is_diag = dir.x != 0 && dir.y != 0;
+                cur_g = Pathfinding::calc_g( this->settings, cur_point_with_z, is_diag,
+                                             cur_vehicle, cur_vehicle_part, next_vehicle );
                 this->g_at( cur_point ) = cur_g;
             }
 
@@ -792,29 +948,515 @@ Pathfinding::ExpansionOutcome Pathfinding::expand_2d_up_to(
 }
 
 
-std::vector<tripoint> Pathfinding::get_route_2d(
-    const point from, const point to, const int z,
-    const PathfindingSettings path_settings,
-    const RouteSettings route_settings )
+/// Pathfinding: hierarchical layer
+Pathfinding::PortalGraph &Pathfinding::get_portal_graph( const PathfindingSettings &settings )
 {
-    if( from == to ) {
-        return std::vector<tripoint> { tripoint( from, z ), tripoint( to, z ) };
+    auto graph_it = std::ranges::find_if( Pathfinding::portal_graphs, [&settings]( auto & graph ) {
+        return graph->settings == settings;
+    } );
+
+    if( graph_it == Pathfinding::portal_graphs.end() ) {
+        std::unique_ptr<PortalGraph> graph = std::make_unique<PortalGraph>();
+        graph->settings = settings;
+        Pathfinding::portal_graphs.push_back( std::move( graph ) );
+    } else {
+        std::rotate( graph_it, std::next( graph_it ), Pathfinding::portal_graphs.end() );
+    }
+    return *Pathfinding::portal_graphs.back();
+}
+void Pathfinding::invalidate_portals( const tripoint &p )
+{
+    const tripoint sm_pos = sm_pos_of( p );
+    const point in_sm( p.x % SEEX, p.y % SEEY );
+
+    for( const std::unique_ptr<PortalGraph> &graph : Pathfinding::portal_graphs ) {
+        graph->submaps.erase( sm_pos );
+        // Border tiles are part of entrances of the neighbouring submap as well
+        if( in_sm.x == 0 ) {
+            graph->submaps.erase( sm_pos + point_west );
+        } else if( in_sm.x == SEEX - 1 ) {
+            graph->submaps.erase( sm_pos + point_east );
+        }
+        if( in_sm.y == 0 ) {
+            graph->submaps.erase( sm_pos + point_north );
+        } else if( in_sm.y == SEEY - 1 ) {
+            graph->submaps.erase( sm_pos + point_south );
+        }
+    }
+}
+void Pathfinding::local_search( const SubmapPortals &sm, const tripoint &sm_pos,
+                                const tripoint &origin, const bool reverse,
+                                LocalCosts &costs, LocalParents &parents )
+{
+    using Frontier = std::priority_queue<std::pair<float, int>, std::vector<std::pair<float, int>>, pair_greater_cmp_first>;
+
+    const map &here = get_map();
+    const point sm_corner = sm_corner_of( sm_pos );
+    const half_open_rectangle<point> area( sm_corner, sm_corner + point( SEEX, SEEY ) );
+
+    // Vehicles may forbid moves between some tiles
+    std::array<const vehicle *, SEEX *SEEY> vehicles;
+    for( int i = 0; i < SEEX * SEEY; i++ ) {
+        int _;
+        vehicles[i] = here.veh_at_internal( tripoint( sm_tile_at( sm_pos, i ), sm_pos.z ), _ );
+    }
+
+    costs.fill( INFINITY );
+    parents.fill( -1 );
+
+    Frontier frontier;
+    const int origin_index = sm_index_of( sm_pos, origin.xy() );
+    costs[origin_index] = 0.0;
+    frontier.emplace( 0.0, origin_index );
+
+    while( !frontier.empty() ) {
+        const auto [cur_cost, cur_index] = frontier.top();
+        frontier.pop();
+
+        if( cur_cost > costs[cur_index] ) {
+            continue;
+        }
+
+        const point cur_point = sm_tile_at( sm_pos, cur_index );
+        for( const point &dir : DIRS_2D ) {
+            const point next_point = cur_point + dir;
+            if( !area.contains( next_point ) ) {
+                continue;
+            }
+            const int next_index = sm_index_of( sm_pos, next_point );
+
+            // The tile we step out of determines the cost
+            const int leaving_index = reverse ? next_index : cur_index;
+            const bool is_diag = dir.x != 0 && dir.y != 0;
+            const float step_g = is_diag ? sm.g_diag[leaving_index] : sm.g_orth[leaving_index];
+            if( is_inf( step_g ) ) {
+                continue;
+            }
+
+            const tripoint cur_point_with_z( cur_point, sm_pos.z );
+            const tripoint next_point_with_z( next_point, sm_pos.z );
+            const bool is_move_valid = reverse ?
+                                       Pathfinding::is_move_allowed( next_point_with_z, cur_point_with_z,
+                                               vehicles[next_index], vehicles[cur_index] ) :
+                                       Pathfinding::is_move_allowed( cur_point_with_z, next_point_with_z,
+                                               vehicles[cur_index], vehicles[next_index] );
+            if( !is_move_valid ) {
+                continue;
+            }
+
+            const float next_cost = cur_cost + step_g;
+            if( next_cost < costs[next_index] ) {
+                costs[next_index] = next_cost;
+                parents[next_index] = cur_index;
+                frontier.emplace( next_cost, next_index );
+            }
+        }
+    }
+}
+Pathfinding::SubmapPortals &Pathfinding::get_submap_portals( PortalGraph &graph,
+        const tripoint &sm_pos )
+{
+    static constexpr std::array<point, 4> DIRS_BORDERS = {
+        point_north,
+        point_east,
+        point_south,
+        point_west,
+    };
+
+    auto sm_it = graph.submaps.find( sm_pos );
+    if( sm_it != graph.submaps.end() ) {
+        return sm_it->second;
+    }
+
+    const map &here = get_map();
+    const PathfindingSettings &settings = graph.settings;
+    const point sm_corner = sm_corner_of( sm_pos );
+    const half_open_rectangle<point> area( sm_corner, sm_corner + point( SEEX, SEEY ) );
+    SubmapPortals &sm = graph.submaps[sm_pos];
+
+    const auto tile_g = [&here, &settings]( const tripoint & p, const bool is_diag ) {
+        int part;
+        const vehicle *veh = here.veh_at_internal( p, part );
+        // We don't know where we are headed, so assume we stay inside the same vehicle
+        return Pathfinding::calc_g( settings, p, is_diag, veh, part, veh );
+    };
+
+    for( int i = 0; i < SEEX * SEEY; i++ ) {
+        const tripoint p( sm_tile_at( sm_pos, i ), sm_pos.z );
+        sm.g_orth[i] = tile_g( p, false );
+        sm.g_diag[i] = tile_g( p, true );
     }
 
+    // Entrances are runs of tiles along the border we can cross both ways
+    for( const point &dir : DIRS_BORDERS ) {
+        const point neighbour_sm = sm_pos.xy() + dir;
+        if( neighbour_sm.x < 0 || neighbour_sm.x >= here.getmapsize() ||
+            neighbour_sm.y < 0 || neighbour_sm.y >= here.getmapsize() ) {
+            continue;
+        }
+
+        const point border_start = sm_corner + point( dir == point_east ? SEEX - 1 : 0,
+                                   dir == point_south ? SEEY - 1 : 0 );
+        const point along = dir.x == 0 ? point_east : point_south;
+        const int border_size = dir.x == 0 ? SEEX : SEEY;
+
+        std::vector<bool> is_open( border_size );
+        for( int i = 0; i < border_size; i++ ) {
+            const tripoint inside( border_start + along * i, sm_pos.z );
+            const tripoint outside = inside + dir;
+            int _;
+            const vehicle *inside_vehicle = here.veh_at_internal( inside, _ );
+            const vehicle *outside_vehicle = here.veh_at_internal( outside, _ );
+            is_open[i] = !is_inf( sm.g_orth[sm_index_of( sm_pos, inside.xy() )] ) &&
+                         !is_inf( tile_g( outside, false ) ) &&
+                         Pathfinding::is_move_allowed( inside, outside, inside_vehicle, outside_vehicle ) &&
+                         Pathfinding::is_move_allowed( outside, inside, outside_vehicle, inside_vehicle );
+        }
+
+        int run_start = -1;
+        for( int i = 0; i <= border_size; i++ ) {
+            if( i < border_size && is_open[i] ) {
+                if( run_start < 0 ) {
+                    run_start = i;
+                }
+                continue;
+            }
+            if( run_start < 0 ) {
+                continue;
+            }
+
+            const int run_end = i - 1;
+            std::vector<int> picks;
+            if( run_end - run_start + 1 >= WIDE_ENTRANCE_SIZE ) {
+                picks = { run_start, run_end };
+            } else {
+                picks = { ( run_start + run_end ) / 2 };
+            }
+            for( const int pick : picks ) {
+                const tripoint inside( border_start + along * pick, sm_pos.z );
+                sm.portals[inside].push_back( PortalEdge{
+                    .to = inside + dir,
+                    .cost = sm.g_orth[sm_index_of( sm_pos, inside.xy() )]
+                } );
+            }
+            run_start = -1;
+        }
+    }
+
+    // Z-level changes
+    const auto can_take = [&settings]( const ZLevelChange & change ) {
+        switch( change.type ) {
+            case ZLevelChange::Type::STAIRS:
+                return settings.can_climb_stairs || settings.can_fly;
+            case ZLevelChange::Type::RAMP:
+                // Ramps can be taken by all creatures currently
+                return true;
+            case ZLevelChange::Type::OPEN_AIR:
+                // Open air is too numerous to be worth turning into portals
+                return false;
+        }
+        return false;
+    };
+    for( const int dz : { -1, 1 } ) {
+        if( !here.inbounds_z( sm_pos.z + dz ) ) {
+            continue;
+        }
+        // Z caches are stored by the level they lead to
+        for( const ZLevelChange &change : Pathfinding::get_z_cache( sm_pos.z + dz ) ) {
+            if( change.from.z != sm_pos.z || !area.contains( change.from.xy() ) || !can_take( change ) ) {
+                continue;
+            }
+            const float cost = sm.g_orth[sm_index_of( sm_pos, change.from.xy() )];
+            if( is_inf( cost ) ) {
+                continue;
+            }
+            sm.portals[change.from].push_back( PortalEdge{
+                .to = change.to,
+                .cost = cost,
+                .is_ramp = change.type == ZLevelChange::Type::RAMP
+            } );
+        }
+    }
+    // Tiles we arrive at from other Z-levels don't lead anywhere by themselves, but still need connecting
+    for( const ZLevelChange &change : Pathfinding::get_z_cache( sm_pos.z ) ) {
+        if( change.to.z == sm_pos.z && area.contains( change.to.xy() ) && can_take( change ) ) {
+            sm.portals[change.to];
+        }
+    }
+
+    // Finally, connect portals within the submap
+    LocalCosts costs;
+    LocalParents parents;
+    for( auto &[portal, edges] : sm.portals ) {
+        Pathfinding::local_search( sm, sm_pos, portal, false, costs, parents );
+        for( const auto &other : sm.portals ) {
+            if( other.first == portal ) {
+                continue;
+            }
+            const float cost = costs[sm_index_of( sm_pos, other.first.xy() )];
+            if( !is_inf( cost ) ) {
+                edges.push_back( PortalEdge{ .to = other.first, .cost = cost } );
+            }
+        }
+    }
+
+    return sm;
+}
+std::optional<std::vector<tripoint>> Pathfinding::get_route_hierarchical(
+                                      const tripoint &from, const tripoint &to,
+                                      const PathfindingSettings &path_settings,
+                                      const RouteSettings &route_settings )
+{
+    using Frontier = std::priority_queue<std::pair<float, tripoint>, std::vector<std::pair<float, tripoint>>, pair_greater_cmp_first>;
+
+    Pathfinding::update_z_caches( path_settings.can_fly );
+    PortalGraph &graph = Pathfinding::get_portal_graph( path_settings );
+
+    // Flood fill `from` and `to` submaps to connect them with their portals
+    const tripoint from_sm_pos = sm_pos_of( from );
+    const tripoint to_sm_pos = sm_pos_of( to );
+    LocalCosts from_costs;
+    LocalParents from_parents;
+    LocalCosts to_costs;
+    LocalParents to_parents;
+    Pathfinding::local_search( Pathfinding::get_submap_portals( graph, from_sm_pos ),
+                               from_sm_pos, from, false, from_costs, from_parents );
+    Pathfinding::local_search( Pathfinding::get_submap_portals( graph, to_sm_pos ),
+                               to_sm_pos, to, true, to_costs, to_parents );
+
+    // Cheapest step is an orthogonal move over flat ground
+    const float h_step = route_settings.h_coeff * path_settings.move_cost_coeff;
+    const auto heuristic = [&to, h_step]( const tripoint & p ) {
+        const int dx = std::abs( p.x - to.x );
+        const int dy = std::abs( p.y - to.y );
+        const int diag = std::min( dx, dy );
+        const int straight = std::max( dx, dy ) - diag;
+        return h_step * ( straight + 1.5f * diag + std::abs( p.z - to.z ) );
+    };
+
+    // A* over the portal graph
+    std::unordered_map<tripoint, float> best_costs;
+    std::unordered_map<tripoint, tripoint> came_from;
+    std::unordered_set<tripoint> closed;
+    Frontier frontier;
+
+    best_costs[from] = 0.0;
+    frontier.emplace( heuristic( from ), from );
+
+    bool is_found = false;
+    while( !frontier.empty() ) {
+        const tripoint cur = frontier.top().second;
+        frontier.pop();
+
+        if( cur == to ) {
+            is_found = true;
+            break;
+        }
+        if( !closed.insert( cur ).second ) {
+            continue;
+        }
+
+        const float cur_cost = best_costs[cur];
+        const auto relax = [&]( const tripoint & next, const float step_cost ) {
+            const float next_cost = cur_cost + step_cost;
+            const auto best_it = best_costs.find( next );
+            if( best_it != best_costs.end() && best_it->second <= next_cost ) {
+                return;
+            }
+            best_costs[next] = next_cost;
+            came_from[next] = cur;
+            frontier.emplace( next_cost + heuristic( next ), next );
+        };
+
+        const tripoint cur_sm_pos = sm_pos_of( cur );
+        const SubmapPortals &cur_sm = Pathfinding::get_submap_portals( graph, cur_sm_pos );
+
+        if( cur == from ) {
+            for( const auto &portal : cur_sm.portals ) {
+                const float cost = from_costs[sm_index_of( cur_sm_pos, portal.first.xy() )];
+                if( !is_inf( cost ) ) {
+                    relax( portal.first, cost );
+                }
+            }
+            if( from_sm_pos == to_sm_pos ) {
+                const float cost = from_costs[sm_index_of( cur_sm_pos, to.xy() )];
+                if( !is_inf( cost ) ) {
+                    relax( to, cost );
+                }
+            }
+        } else if( cur_sm_pos == to_sm_pos ) {
+            const float cost = to_costs[sm_index_of( cur_sm_pos, cur.xy() )];
+            if( !is_inf( cost ) ) {
+                relax( to, cost );
+            }
+        }
+
+        const auto portal_it = cur_sm.portals.find( cur );
+        if( portal_it != cur_sm.portals.end() ) {
+            for( const PortalEdge &edge : portal_it->second ) {
+                relax( edge.to, edge.cost );
+            }
+        }
+    }
+
+    if( !is_found ) {
+        return std::nullopt;
+    }
+
+    const float max_f = route_settings.max_f_coeff * (
+                            route_settings.f_limit_based_on_max_dist ?
+                            route_settings.max_dist :
+                            rl_dist_exact( from, to )
+                        );
+    if( !is_nan( max_f ) && best_costs[to] > max_f ) {
+        return std::vector<tripoint>();
+    }
+
+    std::vector<tripoint> nodes;
+    for( tripoint cur = to; cur != from; cur = came_from[cur] ) {
+        nodes.push_back( cur );
+    }
+    nodes.push_back( from );
+    std::ranges::reverse( nodes );
+
+    // Refine the route submap by submap
+    std::vector<tripoint> result{ from };
+    std::unordered_set<tripoint> ramp_excluded;
+    LocalCosts costs;
+    LocalParents parents;
+    for( size_t i = 1; i < nodes.size(); i++ ) {
+        const tripoint &prev = nodes[i - 1];
+        const tripoint &next = nodes[i];
+        const tripoint prev_sm_pos = sm_pos_of( prev );
+
+        if( prev.z != next.z ) {
+            const SubmapPortals &prev_sm = Pathfinding::get_submap_portals( graph, prev_sm_pos );
+            const std::vector<PortalEdge> &edges = prev_sm.portals.at( prev );
+            const bool is_ramp = std::ranges::any_of( edges, [&next]( const PortalEdge & edge ) {
+                return edge.to == next && edge.is_ramp;
+            } );
+            if( is_ramp && !path_settings.can_fly ) {
+                ramp_excluded.insert( prev );
+            }
+            result.push_back( next );
+            continue;
+        }
+        if( prev_sm_pos != sm_pos_of( next ) ) {
+            // Crossing submap border
+            result.push_back( next );
+            continue;
+        }
+
+        if( next == to && prev != from ) {
+            // Flood fill from `to` already knows the way
+            for( int index = to_parents[sm_index_of( prev_sm_pos, prev.xy() )]; index >= 0;
+                 index = to_parents[index] ) {
+                result.emplace_back( sm_tile_at( prev_sm_pos, index ), prev.z );
+            }
+            continue;
+        }
+
+        const LocalParents *tree = &from_parents;
+        if( prev != from ) {
+            Pathfinding::local_search( Pathfinding::get_submap_portals( graph, prev_sm_pos ),
+                                       prev_sm_pos, prev, false, costs, parents );
+            tree = &parents;
+        }
+        std::vector<tripoint> segment;
+        const int prev_index = sm_index_of( prev_sm_pos, prev.xy() );
+        for( int index = sm_index_of( prev_sm_pos, next.xy() ); index != prev_index;
+             index = ( *tree )[index] ) {
+            if( index < 0 ) {
+                // Portal graph is out of sync with the map somehow
+                return std::nullopt;
+            }
+            segment.emplace_back( sm_tile_at( prev_sm_pos, index ), prev.z );
+        }
+        result.insert( result.end(), segment.rbegin(), segment.rend() );
+    }
+
+    std::erase_if( result, [&ramp_excluded]( const tripoint & p ) {
+        return ramp_excluded.contains( p );
+    } );
+
+    const float max_s = route_settings.max_s_coeff * square_dist( from, to );
+    if( result.size() - 2 > max_s ) {
+        return std::vector<tripoint>();
+    }
+
+    return result;
+}
+
+Pathfinding &Pathfinding::get_d_map( const point &dest, const int z,
+                                     const PathfindingSettings &settings )
+{
     auto d_map_it = std::ranges::find_if(
                         Pathfinding::d_maps,
-    [&to, &path_settings, z]( auto & map ) {
-        return map->dest == to && map->z == z && map->settings == path_settings;
+    [&dest, &settings, z]( auto & map ) {
+        return map->dest == dest && map->z == z && map->settings == settings;
     } );
 
-    Pathfinding *d_map;
     if( d_map_it == Pathfinding::d_maps.end() ) {
-        Pathfinding::produce_d_map( to, z, path_settings );
-        d_map = Pathfinding::d_maps.back().get();
+        Pathfinding::cache_stats.misses++;
+        Pathfinding::produce_d_map( dest, z, settings );
     } else {
-        d_map = d_map_it->get();
+        Pathfinding::cache_stats.hits++;
+        // Keep most recently used maps at the back, so that eviction drops the least recently used ones
+        std::rotate( d_map_it, std::next( d_map_it ), Pathfinding::d_maps.end() );
+    }
+    return *Pathfinding::d_maps.back();
+}
+
+std::optional<Pathfinding::val_pair> Pathfinding::pick_next_step( const point &cur_point,
+        const float cur_cost, const RouteSettings &route_settings )
+{
+    std::vector<val_pair> candidates;
+
+    for( const point &dir : DIRS_2D ) {
+        const point next_point = cur_point + dir;
+        const bool is_in_bounds = this->in_bounds( next_point );
+        if( !is_in_bounds ) {
+            continue;
+        }
+
+        const float cost = this->get_f_unbiased( next_point );
+
+        const bool is_accessible = this->tile_state_at( next_point ) ==
+                                   Pathfinding::State::ACCESSIBLE;
+        const bool is_not_forbidden = !this->forbidden_moves.contains( {cur_point, next_point} );
+
+        const bool is_valid = is_accessible && is_not_forbidden;
+        if( !is_valid ) {
+            continue;
+        };
+
+        if( cost < cur_cost ) {
+            candidates.emplace_back( cost, next_point );
+        }
+    }
+
+    if( candidates.empty() ) {
+        return std::nullopt;
+    }
+
+    std::ranges::sort( candidates, []( auto & p1, auto & p2 ) {
+        return p1.first < p2.first;
+    } );
+
+    return candidates[route_settings.rank_weighted_rng( candidates.size() )];
+}
+
+std::vector<tripoint> Pathfinding::get_route_2d(
+    const point from, const point to, const int z,
+    const PathfindingSettings path_settings,
+    const RouteSettings route_settings )
+{
+    if( from == to ) {
+        return std::vector<tripoint> { tripoint( from, z ), tripoint( to, z ) };
     }
 
+    Pathfinding *d_map = &Pathfinding::get_d_map( to, z, path_settings );
+
     if( !d_map->is_in_limited_domain( from, from, route_settings ) ) {
         // This should only fail if max f-limit is failed
         return std::vector<tripoint>();
@@ -836,51 +1478,21 @@ std::vector<tripoint> Pathfinding::get_route_2d(
     float cur_cost = d_map->get_f_unbiased( cur_point );
 
     while( cur_point != d_map->dest ) {
-        std::vector<std::pair<float, point>> candidates;
-
-        for( const point &dir : DIRS_2D ) {
-            const point next_point = cur_point + dir;
-            const bool is_in_bounds = d_map->in_bounds( next_point );
-            if( !is_in_bounds ) {
-                continue;
-            }
-
-            const float cost = d_map->get_f_unbiased( next_point );
-
-            const bool is_accessible = d_map->tile_state_at( next_point ) ==
-                                       Pathfinding::State::ACCESSIBLE;
-            const bool is_not_forbidden = !d_map->forbidden_moves.contains( {cur_point, next_point} );
-
-            const bool is_valid = is_accessible && is_not_forbidden;
-            if( !is_valid ) {
-                continue;
-            };
-
-            if( cost < cur_cost ) {
-                candidates.emplace_back( cost, next_point );
-            }
-        }
+        const std::optional<val_pair> selected_pair = d_map->pick_next_step( cur_point, cur_cost,
+                route_settings );
 
         // This should not be likely to happen, but...
-        if( candidates.empty() ) {
+        if( !selected_pair.has_value() ) {
             // Maybe instead of looking at directly adjacent points,
             //   increase the radius until we find a gradient?
             result.clear();
             return result;
         }
 
-        std::ranges::sort( candidates, []( auto & p1, auto & p2 ) {
-            return p1.first < p2.first;
-        } );
-
-        const auto selected_pair = &candidates[route_settings.rank_weighted_rng( candidates.size() )];
-
         result.push_back( tripoint( selected_pair->second, d_map->z ) );
         cur_point = selected_pair->second;
         cur_cost = selected_pair->first;
 
-        candidates.clear();
-
         // Path is too long in terms of steps taken
         if( result.size() - 2 > max_s ) {
             result.clear();
@@ -1078,6 +1690,8 @@ std::vector<tripoint> Pathfinding::route(
     here.clip_to_bounds( from );
     here.clip_to_bounds( to );
 
+    Pathfinding::validate_d_maps_origin();
+
     PathfindingSettings path_settings = maybe_path_settings.has_value() ? *maybe_path_settings :
                                         PathfindingSettings();
     RouteSettings route_settings = maybe_route_settings.has_value() ? *maybe_route_settings :
@@ -1087,9 +1701,70 @@ std::vector<tripoint> Pathfinding::route(
         return std::vector<tripoint>();
     }
 
+    const bool use_hierarchical = get_option<bool>( "PATHFINDING_HIERARCHICAL" ) &&
+                                  !route_settings.is_relative_search_domain() &&
+                                  square_dist( from, to ) >= HIERARCHICAL_MIN_DIST;
+    if( use_hierarchical ) {
+        std::optional<std::vector<tripoint>> result = Pathfinding::get_route_hierarchical( from, to,
+                path_settings, route_settings );
+        if( result.has_value() ) {
+            return *result;
+        }
+    }
+
     if( from.z == to.z ) {
         return Pathfinding::get_route_2d( from.xy(), to.xy(), from.z,
                                           path_settings, route_settings );
     }
     return Pathfinding::get_route_3d( from, to, path_settings, route_settings );
 };
+
+std::optional<tripoint> Pathfinding::next_step(
+    tripoint from, tripoint to,
+    const std::optional<PathfindingSettings> maybe_path_settings,
+    const std::optional<RouteSettings> maybe_route_settings )
+{
+    const map &here = get_map();
+
+    here.clip_to_bounds( from );
+    here.clip_to_bounds( to );
+
+    Pathfinding::validate_d_maps_origin();
+
+    PathfindingSettings path_settings = maybe_path_settings.has_value() ? *maybe_path_settings :
+                                        PathfindingSettings();
+    RouteSettings route_settings = maybe_route_settings.has_value() ? *maybe_route_settings :
+                                   RouteSettings();
+
+    if( from == to || rl_dist_exact( from, to ) > route_settings.max_dist ) {
+        return std::nullopt;
+    }
+
+    if( from.z != to.z ) {
+        // Z-level changes are decided over the whole route, so there's no shared field to read from
+        const std::vector<tripoint> route = Pathfinding::route( from, to, path_settings,
+                                            route_settings );
+        const auto step_it = std::ranges::find_if( route, [&from]( const tripoint & p ) {
+            return p != from;
+        } );
+        return step_it == route.end() ? std::nullopt : std::optional<tripoint>( *step_it );
+    }
+
+    Pathfinding &d_map = Pathfinding::get_d_map( to.xy(), to.z, path_settings );
+
+    if( !d_map.is_in_limited_domain( from.xy(), from.xy(), route_settings ) ) {
+        return std::nullopt;
+    }
+
+    // Only expands the field if nobody sharing it has been around here yet
+    if( d_map.expand_2d_up_to( from.xy(), route_settings ) != ExpansionOutcome::PATH_FOUND ) {
+        return std::nullopt;
+    }
+
+    const std::optional<val_pair> step = d_map.pick_next_step( from.xy(),
+                                         d_map.get_f_unbiased( from.xy() ), route_settings );
+    if( !step.has_value() ) {
+        return std::nullopt;
+    }
+    return tripoint( step->second, to.z );
+}
@@ -14,6 +14,7 @@
 #include "point.h"
 #include "rng.h"
 
+class vehicle;
 
 // A struct defining abilities of the actor and how to respond to various terrain features
 struct PathfindingSettings {
@@ -173,6 +174,18 @@ struct RouteSettings {
 
 class Pathfinding
 {
+    public:
+        // Counters describing how well d_maps are reused, accumulated since last `reset_cache_stats()`
+        struct CacheStats {
+            // Route requests served by an already existing d_map
+            int hits = 0;
+            // Route requests that had to produce a new d_map
+            int misses = 0;
+            // d_maps discarded because the map changed under them
+            int invalidations = 0;
+            // d_maps discarded because the cache went over its budget
+            int evictions = 0;
+        };
     private:
         using val_pair = std::pair<float, point>;
 
@@ -215,9 +228,17 @@ class Pathfinding
         // Global state: allocated dijikstra d_maps. Pull to `d_maps` from here.
         static std::vector<std::unique_ptr<Pathfinding>> d_maps_store;
 
-        // Global state: memoized dijikstra d_maps. Transfer to `d_maps_store` every game turn.
+        // Global state: memoized dijikstra d_maps, least recently used first.
+        // They persist between turns until invalidated by a map change or evicted by the cache budget.
         static std::vector<std::unique_ptr<Pathfinding>> d_maps;
 
+        // Global state: position of the loaded map (top left loaded submap, in submap coords) `d_maps` were made for.
+        // All d_maps are in local coordinates, so they are dropped whenever the map shifts.
+        static tripoint d_maps_origin;
+
+        // Global state: d_map cache counters
+        static CacheStats cache_stats;
+
         // We store the area covered by last Z-scan (in global coords, top left loaded submap)
         // ```
         // -----
@@ -242,6 +263,35 @@ class Pathfinding
         // Global state: We cache `z_path` information taken to prevent multiple iterations for the same target
         static std::map<std::tuple<bool, int, tripoint>, ZLevelChange> cached_closest_z_changes;
 
+        // Hierarchical layer: portals are tiles through which routes can leave a submap,
+        //   either across its border or to another Z-level.
+        // Long routes are searched for on the graph of portals first, and then refined submap by submap.
+        struct PortalEdge {
+            tripoint to;
+            float cost;
+            // Ramps are special in that we do not step on the last tile unless we're flying
+            bool is_ramp = false;
+        };
+        struct SubmapPortals {
+            // g-values of all tiles of the submap when leaving them orthogonally or diagonally
+            std::array<float, SEEX *SEEY> g_orth;
+            std::array<float, SEEX *SEEY> g_diag;
+            // Portals of this submap and the edges leaving them
+            std::unordered_map<tripoint, std::vector<PortalEdge>> portals;
+        };
+        struct PortalGraph {
+            // `settings` the graph was built for
+            PathfindingSettings settings;
+            // Keyed by local submap position, built lazily. Removing an entry marks it for rebuilding.
+            std::unordered_map<tripoint, SubmapPortals> submaps;
+        };
+        using LocalCosts = std::array<float, SEEX *SEEY>;
+        // Index of the previous tile on the way from search origin, -1 if none
+        using LocalParents = std::array<int, SEEX *SEEY>;
+
+        // Global state: portal graphs for each `PathfindingSettings` in use, least recently used first
+        static std::vector<std::unique_ptr<PortalGraph>> portal_graphs;
+
         // Smallest adjacent f
         std::array<std::array<float, MAPSIZE_X>, MAPSIZE_Y> p_map;
         // Associated tile's g cost [movement, bashing down...]
@@ -284,6 +334,50 @@ class Pathfinding
         static std::unordered_map<point, ZLevelChangeOpenAirPair> &get_z_cache_open_air( const int z );
 
         static void produce_d_map( point dest, int z, PathfindingSettings settings );
+        // Find d_map for `dest` or produce a new one
+        static Pathfinding &get_d_map( const point &dest, int z, const PathfindingSettings &settings );
+        // Reset `d_map` and return it to `d_maps_store`
+        static void recycle_d_map( std::unique_ptr<Pathfinding> &&d_map );
+        // Recycle all d_maps matching `pred`, returns how many were recycled
+        template<typename Pred>
+        static int recycle_d_maps_if( Pred pred );
+        // Drop all d_maps if the loaded map has moved since they were made
+        static void validate_d_maps_origin();
+
+        // Could a change to the tile at `p` alter any value already calculated by this map?
+        bool depends_on( const point &p );
+        // Do maps made with `settings` depend on anything that may change between turns without a map change, such as critter positions?
+        static bool is_volatile( const PathfindingSettings &settings );
+
+        // Can we step from `from` into adjacent `to` as far as vehicles are concerned?
+        static bool is_move_allowed( const tripoint &from, const tripoint &to,
+                                     const vehicle *from_vehicle, const vehicle *to_vehicle );
+        // g-cost of the tile `p` when leaving it (diagonally if `is_diag`) towards a tile occupied by `next_vehicle`
+        static float calc_g( const PathfindingSettings &settings, const tripoint &p, bool is_diag,
+                             const vehicle *p_vehicle, int p_vehicle_part, const vehicle *next_vehicle );
+
+        // Find or create portal graph for `settings`
+        static PortalGraph &get_portal_graph( const PathfindingSettings &settings );
+        // Get portals of submap at `sm_pos`, building them if needed
+        static SubmapPortals &get_submap_portals( PortalGraph &graph, const tripoint &sm_pos );
+        // Mark submap containing `p` as needing to be rebuilt, along with neighbours whose border portals it may affect
+        static void invalidate_portals( const tripoint &p );
+        // Dijkstra restricted to the submap at `sm_pos`, starting at `origin`.
+        // Going in `reverse` finds costs of reaching `origin` from each tile instead,
+        //   with `parents` holding the next tile on the way to `origin`.
+        static void local_search( const SubmapPortals &sm, const tripoint &sm_pos,
+                                  const tripoint &origin, bool reverse,
+                                  LocalCosts &costs, LocalParents &parents );
+        // See `Pathfinding::route`. Returns `std::nullopt` if the portal graph could not find a route,
+        //   in which case a full search is still needed.
+        static std::optional<std::vector<tripoint>> get_route_hierarchical(
+                    const tripoint &from, const tripoint &to,
+                    const PathfindingSettings &path_settings,
+                    const RouteSettings &route_settings );
+
+        // Pick the tile to go to from `cur_point` whose cost `cur_cost` is known, in accordance to `route_settings`
+        std::optional<val_pair> pick_next_step( const point &cur_point, float cur_cost,
+                                                const RouteSettings &route_settings );
 
         // Get `p`-value at `p`
         float &p_at( const point &p );
@@ -330,9 +424,29 @@ class Pathfinding
                                             const std::optional<PathfindingSettings> path_settings = std::nullopt,
                                             const std::optional<RouteSettings> route_settings = std::nullopt );
 
+        // Flow field mode: get the first step of the route from `from` to `to`, same as the second tile of `route`.
+        // Everyone going to the same `to` with the same `path_settings` shares one d_map,
+        //   so once the field has been expanded past `from` this is just a look at adjacent tiles.
+        // Does not apply `max_s_coeff` since the route isn't built.
+        static std::optional<tripoint> next_step( tripoint from, tripoint to,
+                const std::optional<PathfindingSettings> path_settings = std::nullopt,
+                const std::optional<RouteSettings> route_settings = std::nullopt );
+
         // Reset whole pathfinding pretty much
         static void clear_d_maps();
 
+        // Called at the end of each turn. Drops d_maps that can't outlive a turn
+        //   and evicts least recently used ones above the `PATHFINDING_CACHE_SIZE` budget.
+        static void retire_d_maps();
+
+        // Discard all d_maps on `z` level
+        static void invalidate_d_maps( int z );
+        // Discard only d_maps which have already explored the tile at `p`
+        static void invalidate_d_maps( const tripoint &p );
+
+        static const CacheStats &get_cache_stats();
+        static void reset_cache_stats();
+
         // Reset Z-level information. Should only be done when new Z-level changes could have appeared
         //   such as change in terrain
         static void mark_dirty_z_cache();
@@ -1,24 +1,27 @@
 #include "rng.h"
 #include "weighted_list.h"
 
+#include <atomic>
 #include <cmath>
 #include <chrono>
+#include <cstdint>
 #include <utility>
 
 #include "calendar.h"
+#include "point.h"
 #include "cata_utility.h"
 #include "units.h"
 
 unsigned int rng_bits()
 {
     // Whole uint range.
-    static std::uniform_int_distribution<unsigned int> rng_uint_dist;
+    thread_local std::uniform_int_distribution<unsigned int> rng_uint_dist;
     return rng_uint_dist( rng_get_engine() );
 }
 
 int rng( int lo, int hi )
 {
-    static std::uniform_int_distribution<int> rng_int_dist;
+    thread_local std::uniform_int_distribution<int> rng_int_dist;
     if( lo > hi ) {
         std::swap( lo, hi );
     }
@@ -27,7 +30,7 @@ int rng( int lo, int hi )
 
 double rng_float( double lo, double hi )
 {
-    static std::uniform_real_distribution<double> rng_real_dist;
+    thread_local std::uniform_real_distribution<double> rng_real_dist;
     if( lo > hi ) {
         std::swap( lo, hi );
     }
@@ -39,15 +42,17 @@ units::angle random_direction()
     return rng_float( 0_pi_radians, 2_pi_radians );
 }
 
+// Outside of normal_roll, because it keeps a value for the next call that scoped_rng_seed must reset
+static thread_local std::normal_distribution<double> rng_normal_dist;
+
 double normal_roll( double mean, double stddev )
 {
-    static std::normal_distribution<double> rng_normal_dist;
     return rng_normal_dist( rng_get_engine(), std::normal_distribution<>::param_type( mean, stddev ) );
 }
 
 double exponential_roll( double lambda )
 {
-    static std::exponential_distribution<double> rng_exponential_dist;
+    thread_local std::exponential_distribution<double> rng_exponential_dist;
     return rng_exponential_dist( rng_get_engine(),
                                  std::exponential_distribution<>::param_type( lambda ) );
 }
@@ -133,21 +138,56 @@ double rng_normal( double lo, double hi )
     return clamp( val, lo, hi );
 }
 
+// Last seed given to rng_set_engine_seed, for engines of threads that start afterwards
+static std::atomic<unsigned int> engine_seed{ 0 };
+
 cata_default_random_engine &rng_get_engine()
 {
-    // NOLINTNEXTLINE(cata-determinism)
-    static cata_default_random_engine eng(
-        std::chrono::high_resolution_clock::now().time_since_epoch().count() );
+    thread_local cata_default_random_engine eng = []() {
+        if( const unsigned int seed = engine_seed.load( std::memory_order_relaxed ) ) {
+            return cata_default_random_engine( seed );
+        }
+        // NOLINTNEXTLINE(cata-determinism)
+        return cata_default_random_engine(
+                   std::chrono::high_resolution_clock::now().time_since_epoch().count() );
+    }();
     return eng;
 }
 
 void rng_set_engine_seed( unsigned int seed )
 {
     if( seed != 0 ) {
+        engine_seed.store( seed, std::memory_order_relaxed );
         rng_get_engine().seed( seed );
     }
 }
 
+unsigned int rng_location_seed( unsigned int seed, rng_seed_domain domain, const tripoint &p )
+{
+    // FNV-1a style mixing, one value at a time
+    uint64_t hash = seed;
+    for( const uint32_t value : {
+             static_cast<uint32_t>( domain ), static_cast<uint32_t>( p.x ),
+             static_cast<uint32_t>( p.y ), static_cast<uint32_t>( p.z )
+         } ) {
+        hash = ( hash ^ value ) * 0x100000001B3ULL;
+    }
+    return static_cast<unsigned int>( hash ^ ( hash >> 32 ) );
+}
+
+scoped_rng_seed::scoped_rng_seed( unsigned int seed ) : saved( rng_get_engine() ),
+    saved_normal( rng_normal_dist )
+{
+    rng_get_engine().seed( seed );
+    rng_normal_dist.reset();
+}
+
+scoped_rng_seed::~scoped_rng_seed()
+{
+    rng_get_engine() = saved;
+    rng_normal_dist = saved_normal;
+}
+
 namespace weighted_list_detail
 {
 unsigned int gen_rand_i()
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <functional>
 #include <iosfwd>
 #include <optional>
@@ -19,13 +20,50 @@ struct tripoint;
 // All PRNG functions use an engine, see the C++11 <random> header
 // By default, that engine is seeded by time on first call to such a function.
 // If this function is called with a non-zero seed then the engine will be
-// seeded (or re-seeded) with the given seed.
+// seeded (or re-seeded) with the given seed. Engines of other threads that
+// haven't been used yet will start from the same seed.
 void rng_set_engine_seed( unsigned int seed );
 
 using cata_default_random_engine = std::minstd_rand0;
+/**
+ * Every thread has its own engine, so threads don't disturb each other's sequences.
+ * Which thread picks up a job isn't fixed, so jobs on worker threads that need reproducible
+ * results should draw under a scoped_rng_seed.
+ */
 cata_default_random_engine &rng_get_engine();
 unsigned int rng_bits();
 
+/** What a location seed is for, so different uses of the same location get unrelated numbers. */
+enum class rng_seed_domain : uint32_t {
+    mapgen,
+    overmap,
+};
+
+/**
+ * Seed for random numbers that belong to a location, e.g. for generating it. Mixes `seed` (usually
+ * the world seed) with `domain` and the location only, so it doesn't matter in which order locations
+ * use theirs.
+ */
+unsigned int rng_location_seed( unsigned int seed, rng_seed_domain domain, const tripoint &p );
+
+/**
+ * Reseeds the engine of the current thread with `seed` for the lifetime of this object and
+ * restores the previous engine state afterwards. For results that shouldn't depend on what
+ * used the engine before, e.g. mapgen.
+ */
+class scoped_rng_seed
+{
+    public:
+        explicit scoped_rng_seed( unsigned int seed );
+        ~scoped_rng_seed();
+        scoped_rng_seed( const scoped_rng_seed & ) = delete;
+        scoped_rng_seed &operator=( const scoped_rng_seed & ) = delete;
+
+    private:
+        cata_default_random_engine saved;
+        std::normal_distribution<double> saved_normal;
+};
+
 int rng( int lo, int hi );
 double rng_float( double lo, double hi );
 
@@ -21,6 +21,9 @@
 #include <set>
 #include <sstream>
 #include <stack>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -31,6 +34,7 @@
 #include "assign.h"
 #include "auto_pickup.h"
 #include "avatar.h"
+#include "binary_io.h"
 #include "bionics.h"
 #include "bodypart.h"
 #include "calendar.h"
@@ -3275,7 +3279,7 @@ struct mm_elem {
     }
 };
 
-void mm_submap::serialize( JsonOut &jsout ) const
+void mm_submap::serialize( JsonOut &jsout, memorized_tile_table &table ) const
 {
     jsout.start_array();
 
@@ -3286,7 +3290,7 @@ void mm_submap::serialize( JsonOut &jsout ) const
 
     const auto write_seq = [&]() {
         jsout.start_array();
-        jsout.write( last.tile.tile );
+        jsout.write( table.index_of( last.tile.tile ) );
         jsout.write( last.tile.subtile );
         jsout.write( last.tile.rotation );
         jsout.write( last.symbol );
@@ -3318,7 +3322,7 @@ void mm_submap::serialize( JsonOut &jsout ) const
     jsout.end_array();
 }
 
-void mm_submap::deserialize( JsonIn &jsin )
+void mm_submap::deserialize( JsonIn &jsin, const std::vector<memorized_tile_id> &table )
 {
     jsin.start_array();
 
@@ -3333,7 +3337,15 @@ void mm_submap::deserialize( JsonIn &jsin )
                 remaining -= 1;
             } else {
                 jsin.start_array();
-                elem.tile.tile = jsin.get_string();
+                if( jsin.test_string() ) {
+                    elem.tile.tile = memorized_tile_id( jsin.get_string() );
+                } else {
+                    const int index = jsin.get_int();
+                    if( index < 0 || static_cast<size_t>( index ) >= table.size() ) {
+                        jsin.error( "tile id index out of range" );
+                    }
+                    elem.tile.tile = table[index];
+                }
                 elem.tile.subtile = jsin.get_int();
                 elem.tile.rotation = jsin.get_int();
                 elem.symbol = jsin.get_int();
@@ -3357,6 +3369,9 @@ void mm_submap::deserialize( JsonIn &jsin )
 
 void mm_region::serialize( JsonOut &jsout ) const
 {
+    memorized_tile_table table;
+    jsout.start_object();
+    jsout.member( "submaps" );
     jsout.start_array();
     // NOLINTNEXTLINE(modernize-loop-convert): leaving as is for readability
     for( size_t y = 0; y < MM_REG_SIZE; y++ ) {
@@ -3366,32 +3381,57 @@ void mm_region::serialize( JsonOut &jsout ) const
             if( sm->is_empty() ) {
                 jsout.write_null();
             } else {
-                sm->serialize( jsout );
+                sm->serialize( jsout, table );
             }
         }
     }
     jsout.end_array();
+    // After the submaps, which fill the table
+    jsout.member( "tile_ids" );
+    jsout.start_array();
+    for( const memorized_tile_id &id : table.ids() ) {
+        jsout.write( id.str() );
+    }
+    jsout.end_array();
+    jsout.end_object();
 }
 
-void mm_region::deserialize( JsonIn &jsin )
+static void deserialize_mm_submaps( mm_region &reg, JsonIn &jsin,
+                                   const std::vector<memorized_tile_id> &table )
 {
     jsin.start_array();
     // NOLINTNEXTLINE(modernize-loop-convert): leaving as is for readability
     for( size_t y = 0; y < MM_REG_SIZE; y++ ) {
         // NOLINTNEXTLINE(modernize-loop-convert): leaving as is for readability
         for( size_t x = 0; x < MM_REG_SIZE; x++ ) {
-            shared_ptr_fast<mm_submap> &sm = submaps[x][y];
+            shared_ptr_fast<mm_submap> &sm = reg.submaps[x][y];
             sm = make_shared_fast<mm_submap>();
             if( jsin.test_null() ) {
                 jsin.skip_null();
             } else {
-                sm->deserialize( jsin );
+                sm->deserialize( jsin, table );
             }
         }
     }
     jsin.end_array();
 }
 
+void mm_region::deserialize( JsonIn &jsin )
+{
+    // Saves from before tile ids were numbered are just the array of submaps
+    if( !jsin.test_object() ) {
+        deserialize_mm_submaps( *this, jsin, {} );
+        return;
+    }
+    // The table is written after the submaps, it's filled while writing them
+    JsonObject jo = jsin.get_object();
+    std::vector<memorized_tile_id> table;
+    for( const std::string id : jo.get_array( "tile_ids" ) ) {
+        table.emplace_back( id );
+    }
+    deserialize_mm_submaps( *this, *jo.get_raw( "submaps" ), table );
+}
+
 void map_memory::load_legacy( JsonIn &jsin )
 {
     struct mig_elem {
@@ -3409,7 +3449,7 @@ void map_memory::load_legacy( JsonIn &jsin )
         p.y = jsin.get_int();
         p.z = jsin.get_int();
         mig_elem &elem = elems[p];
-        elem.tile.tile = jsin.get_string();
+        elem.tile.tile = memorized_tile_id( jsin.get_string() );
         elem.tile.subtile = jsin.get_int();
         elem.tile.rotation = jsin.get_int();
         jsin.end_array();
@@ -3704,7 +3744,7 @@ void submap::store( JsonOut &jsout ) const
     for( int j = 0; j < SEEY; j++ ) {
         // NOLINTNEXTLINE(modernize-loop-convert)
         for( int i = 0; i < SEEX; i++ ) {
-            const std::string this_id = ter[i][j].obj().id.str();
+            const std::string this_id = tiles().ter[i][j].obj().id.str();
             if( !last_id.empty() ) {
                 if( this_id == last_id ) {
                     num_same++;
@@ -3784,12 +3824,12 @@ void submap::store( JsonOut &jsout ) const
     jsout.start_array();
     for( int j = 0; j < SEEY; j++ ) {
         for( int i = 0; i < SEEX; i++ ) {
-            if( itm[i][j].empty() ) {
+            if( tiles().itm[i][j].empty() ) {
                 continue;
             }
             jsout.write( i );
             jsout.write( j );
-            jsout.write( itm[i][j] );
+            jsout.write( tiles().itm[i][j] );
         }
     }
     jsout.end_array();
@@ -3817,11 +3857,11 @@ void submap::store( JsonOut &jsout ) const
     for( int j = 0; j < SEEY; j++ ) {
         for( int i = 0; i < SEEX; i++ ) {
             // Save fields
-            if( fld[i][j].field_count() > 0 ) {
+            if( tiles().fld[i][j].field_count() > 0 ) {
                 jsout.write( i );
                 jsout.write( j );
                 jsout.start_array();
-                for( auto &elem : fld[i][j] ) {
+                for( auto &elem : tiles().fld[i][j] ) {
                     const field_entry &cur = elem.second;
                     jsout.write( cur.get_field_type().id() );
                     jsout.write( cur.get_field_intensity() );
@@ -3833,6 +3873,11 @@ void submap::store( JsonOut &jsout ) const
     }
     jsout.end_array();
 
+    store_entities( jsout );
+}
+
+void submap::store_entities( JsonOut &jsout ) const
+{
     // Write out as array of arrays of single entries
     jsout.member( "cosmetics" );
     jsout.start_array();
@@ -3942,7 +3987,7 @@ void submap::load( JsonIn &jsin, const std::string &member_name, int version,
                 } else {
                     --remaining;
                 }
-                ter[i][j] = iid;
+                mutable_tiles().ter[i][j] = iid;
             }
         }
         if( remaining ) {
@@ -3968,7 +4013,7 @@ void submap::load( JsonIn &jsin, const std::string &member_name, int version,
             jsin.start_array();
             int i = jsin.get_int();
             int j = jsin.get_int();
-            frn[i][j] = furn_id( jsin.get_string() );
+            mutable_tiles().frn[i][j] = furn_id( jsin.get_string() );
             jsin.end_array();
         }
     } else if( member_name == "items" ) {
@@ -3976,35 +4021,9 @@ void submap::load( JsonIn &jsin, const std::string &member_name, int version,
         while( !jsin.end_array() ) {
             int i = jsin.get_int();
             int j = jsin.get_int();
-            const point p( i, j );
-            jsin.start_array();
-            while( !jsin.end_array() ) {
-                detached_ptr<item> tmp;
-                jsin.read( tmp );
-
-                if( tmp->is_emissive() ) {
-                    update_lum_add( p, *tmp );
-                }
-
-                if( savegame_loading_version >= 27 && version < 27 ) {
-                    tmp->legacy_fast_forward_time();
-                }
-                item &obj = *tmp;
-                itm[p.x][p.y].push_back( std::move( tmp ) );
-                if( obj.needs_processing() ) {
-                    active_items.add( obj );
-                }
-            }
-        }
-        for( auto &it1 : itm ) {
-            for( auto &it2 : it1 ) {
-                std::vector<detached_ptr<item>> cleared = it2.clear();
-                to_cbc_migration::migrate( cleared );
-                for( detached_ptr<item> &item : cleared ) {
-                    it2.push_back( std::move( item ) );
-                }
-            }
+            load_item_stack( jsin, point( i, j ), version );
         }
+        migrate_loaded_items();
     } else if( member_name == "traps" ) {
         jsin.start_array();
         while( !jsin.end_array() ) {
@@ -4013,7 +4032,7 @@ void submap::load( JsonIn &jsin, const std::string &member_name, int version,
             int j = jsin.get_int();
             const point p( i, j );
             // TODO: jsin should support returning an id like jsin.get_id<trap>()
-            trp[p.x][p.y] = trap_str_id( jsin.get_string() ).id();
+            mutable_tiles().trp[p.x][p.y] = trap_str_id( jsin.get_string() ).id();
             jsin.end_array();
         }
     } else if( member_name == "fields" ) {
@@ -4040,10 +4059,10 @@ void submap::load( JsonIn &jsin, const std::string &member_name, int version,
                 } else {
                     ft = field_types::get_field_type_by_legacy_enum( type_int ).id;
                 }
-                if( fld[i][j].find_field( ft ) == nullptr ) {
+                if( mutable_tiles().fld[i][j].find_field( ft ) == nullptr ) {
                     field_count++;
                 }
-                fld[i][j].add_field( ft, intensity, time_duration::from_turns( age ) );
+                mutable_tiles().fld[i][j].add_field( ft, intensity, time_duration::from_turns( age ) );
             }
         }
     } else if( member_name == "graffiti" ) {
@@ -4158,6 +4177,239 @@ void submap::load( JsonIn &jsin, const std::string &member_name, int version,
     }
 }
 
+void submap::load_item_stack( JsonIn &jsin, point p, int version )
+{
+    jsin.start_array();
+    while( !jsin.end_array() ) {
+        detached_ptr<item> tmp;
+        jsin.read( tmp );
+
+        if( tmp->is_emissive() ) {
+            update_lum_add( p, *tmp );
+        }
+
+        if( savegame_loading_version >= 27 && version < 27 ) {
+            tmp->legacy_fast_forward_time();
+        }
+        item &obj = *tmp;
+        mutable_tiles().itm[p.x][p.y].push_back( std::move( tmp ) );
+        if( obj.needs_processing() ) {
+            active_items.add( obj );
+        }
+    }
+}
+
+void submap::migrate_loaded_items()
+{
+    for( auto &it1 : mutable_tiles().itm ) {
+        for( auto &it2 : it1 ) {
+            std::vector<detached_ptr<item>> cleared = it2.clear();
+            to_cbc_migration::migrate( cleared );
+            for( detached_ptr<item> &item : cleared ) {
+                it2.push_back( std::move( item ) );
+            }
+        }
+    }
+}
+
+// Tiles of binary layers are in the same order as the JSON ones, row by row.
+static point binary_tile( size_t index )
+{
+    return point( index % SEEX, index / SEEX );
+}
+
+/**
+ * Layer of ids as a palette of string ids, then runs of (palette index, length).
+ * Same ids next to each other are common, and the palette keeps each string to a single copy.
+ */
+template<typename IntId>
+static void write_palette_layer( cata::binary_writer &out, const IntId( &layer )[SEEX][SEEY] )
+{
+    std::vector<IntId> palette;
+    std::vector<std::pair<size_t, size_t>> runs;
+    for( size_t index = 0; index < SEEX * SEEY; index++ ) {
+        const point p = binary_tile( index );
+        const IntId &id = layer[p.x][p.y];
+        auto found = std::find( palette.begin(), palette.end(), id );
+        const size_t palette_index = found - palette.begin();
+        if( found == palette.end() ) {
+            palette.push_back( id );
+        }
+        if( !runs.empty() && runs.back().first == palette_index ) {
+            runs.back().second++;
+        } else {
+            runs.emplace_back( palette_index, 1 );
+        }
+    }
+    out.write_varint( palette.size() );
+    for( const IntId &id : palette ) {
+        out.write_string( id.id().str() );
+    }
+    out.write_varint( runs.size() );
+    for( const std::pair<size_t, size_t> &run : runs ) {
+        out.write_varint( run.first );
+        out.write_varint( run.second );
+    }
+}
+
+template<typename IntId>
+static void read_palette_layer( cata::binary_reader &in, IntId( &layer )[SEEX][SEEY] )
+{
+    using str_id = std::remove_cvref_t<decltype( std::declval<IntId>().id() )>;
+    std::vector<IntId> palette( in.read_varint() );
+    for( IntId &id : palette ) {
+        id = str_id( std::string( in.read_string() ) ).id();
+    }
+    const size_t num_runs = in.read_varint();
+    size_t index = 0;
+    for( size_t run = 0; run < num_runs; run++ ) {
+        const size_t palette_index = in.read_varint();
+        const size_t length = in.read_varint();
+        if( palette_index >= palette.size() || length > SEEX * SEEY - index ) {
+            throw std::runtime_error( "Mapbuffer layer data is corrupt" );
+        }
+        for( size_t end = index + length; index < end; index++ ) {
+            const point p = binary_tile( index );
+            layer[p.x][p.y] = palette[palette_index];
+        }
+    }
+    if( index != SEEX * SEEY ) {
+        throw std::runtime_error( "Mapbuffer layer data is corrupt" );
+    }
+}
+
+void submap::store_binary( cata::binary_writer &out ) const
+{
+    out.write_signed( to_turn<int>( last_touched ) );
+    out.write_signed( temperature );
+
+    write_palette_layer( out, tiles().ter );
+    write_palette_layer( out, tiles().frn );
+    write_palette_layer( out, tiles().trp );
+
+    std::vector<std::pair<int, size_t>> rad_runs;
+    for( size_t index = 0; index < SEEX * SEEY; index++ ) {
+        const int r = get_radiation( binary_tile( index ) );
+        if( !rad_runs.empty() && rad_runs.back().first == r ) {
+            rad_runs.back().second++;
+        } else {
+            rad_runs.emplace_back( r, 1 );
+        }
+    }
+    out.write_varint( rad_runs.size() );
+    for( const std::pair<int, size_t> &run : rad_runs ) {
+        out.write_signed( run.first );
+        out.write_varint( run.second );
+    }
+
+    std::vector<size_t> field_tiles;
+    for( size_t index = 0; index < SEEX * SEEY; index++ ) {
+        const point p = binary_tile( index );
+        if( tiles().fld[p.x][p.y].field_count() > 0 ) {
+            field_tiles.push_back( index );
+        }
+    }
+    out.write_varint( field_tiles.size() );
+    for( size_t index : field_tiles ) {
+        const point p = binary_tile( index );
+        out.write_varint( index );
+        out.write_varint( tiles().fld[p.x][p.y].field_count() );
+        for( auto &elem : tiles().fld[p.x][p.y] ) {
+            const field_entry &cur = elem.second;
+            out.write_string( cur.get_field_type().id().str() );
+            out.write_signed( cur.get_field_intensity() );
+            out.write_signed( to_turns<int>( cur.get_field_age() ) );
+        }
+    }
+
+    // Items are far too varied for anything but their JSON, so each stack is embedded as is
+    std::vector<size_t> item_tiles;
+    for( size_t index = 0; index < SEEX * SEEY; index++ ) {
+        const point p = binary_tile( index );
+        if( !tiles().itm[p.x][p.y].empty() ) {
+            item_tiles.push_back( index );
+        }
+    }
+    out.write_varint( item_tiles.size() );
+    for( size_t index : item_tiles ) {
+        const point p = binary_tile( index );
+        std::ostringstream stack;
+        JsonOut jsout( stack );
+        jsout.write( tiles().itm[p.x][p.y] );
+        out.write_varint( index );
+        out.write_string( stack.str() );
+    }
+
+    std::ostringstream entities;
+    JsonOut jsout( entities );
+    jsout.start_object();
+    store_entities( jsout );
+    jsout.end_object();
+    out.write_string( entities.str() );
+}
+
+void submap::load_binary( cata::binary_reader &in, int version, const tripoint &offset )
+{
+    last_touched = calendar::turn_zero + time_duration::from_turns( in.read_signed() );
+    temperature = in.read_signed();
+
+    read_palette_layer( in, mutable_tiles().ter );
+    read_palette_layer( in, mutable_tiles().frn );
+    read_palette_layer( in, mutable_tiles().trp );
+
+    const size_t num_rad_runs = in.read_varint();
+    size_t rad_cell = 0;
+    for( size_t run = 0; run < num_rad_runs; run++ ) {
+        const int r = in.read_signed();
+        const size_t length = in.read_varint();
+        if( length > SEEX * SEEY - rad_cell ) {
+            throw std::runtime_error( "Mapbuffer radiation data is corrupt" );
+        }
+        for( size_t end = rad_cell + length; rad_cell < end; rad_cell++ ) {
+            set_radiation( binary_tile( rad_cell ), r );
+        }
+    }
+
+    const size_t num_field_tiles = in.read_varint();
+    for( size_t tile = 0; tile < num_field_tiles; tile++ ) {
+        const size_t index = in.read_varint();
+        if( index >= SEEX * SEEY ) {
+            throw std::runtime_error( "Mapbuffer field data is corrupt" );
+        }
+        const point p = binary_tile( index );
+        const size_t num_fields = in.read_varint();
+        for( size_t i = 0; i < num_fields; i++ ) {
+            const field_type_id ft = field_type_str_id( std::string( in.read_string() ) ).id();
+            const int intensity = in.read_signed();
+            const int age = in.read_signed();
+            if( mutable_tiles().fld[p.x][p.y].find_field( ft ) == nullptr ) {
+                field_count++;
+            }
+            mutable_tiles().fld[p.x][p.y].add_field( ft, intensity, time_duration::from_turns( age ) );
+        }
+    }
+
+    const size_t num_item_tiles = in.read_varint();
+    for( size_t tile = 0; tile < num_item_tiles; tile++ ) {
+        const size_t index = in.read_varint();
+        if( index >= SEEX * SEEY ) {
+            throw std::runtime_error( "Mapbuffer item data is corrupt" );
+        }
+        std::istringstream stack( std::string( in.read_string() ) );
+        JsonIn jsin( stack );
+        load_item_stack( jsin, binary_tile( index ), version );
+    }
+    migrate_loaded_items();
+
+    std::istringstream entities( std::string( in.read_string() ) );
+    JsonIn jsin( entities );
+    jsin.start_object();
+    while( !jsin.end_object() ) {
+        const std::string member_name = jsin.get_member_name();
+        load( jsin, member_name, version, offset );
+    }
+}
+
 void advanced_inv_pane_save_state::serialize( JsonOut &json, const std::string &prefix ) const
 {
     json.member( prefix + "sort_idx", sort_idx );
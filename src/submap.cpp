@@ -4,6 +4,8 @@
 #include <array>
 #include <iterator>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
 
 #include "int_id.h"
@@ -29,12 +31,23 @@ void maptile_soa<sx, sy>::swap_soa_tile( point p1, point p2 )
 
 void submap::swap( submap &first, submap &second )
 {
-    std::swap( first.ter, second.ter );
-    std::swap( first.frn, second.frn );
-    std::swap( first.lum, second.lum );
-    std::swap( first.fld, second.fld );
-    std::swap( first.trp, second.trp );
-    std::swap( first.rad, second.rad );
+    if( first.shares_tiles() && second.shares_tiles() ) {
+        std::swap( first.shared_tiles, second.shared_tiles );
+    } else {
+        tile_storage &first_tiles = first.mutable_tiles();
+        tile_storage &second_tiles = second.mutable_tiles();
+        std::swap( first_tiles.ter, second_tiles.ter );
+        std::swap( first_tiles.frn, second_tiles.frn );
+        std::swap( first_tiles.lum, second_tiles.lum );
+        std::swap( first_tiles.fld, second_tiles.fld );
+        std::swap( first_tiles.trp, second_tiles.trp );
+        std::swap( first_tiles.rad, second_tiles.rad );
+        for( int x = 0; x < SEEX; x++ ) {
+            for( int y = 0; y < SEEY; y++ ) {
+                std::swap( first_tiles.itm[x][y], second_tiles.itm[x][y] );
+            }
+        }
+    }
     std::swap( first.is_uniform, second.is_uniform );
     std::swap( first.active_items, second.active_items );
     std::swap( first.field_count, second.field_count );
@@ -48,12 +61,6 @@ void submap::swap( submap &first, submap &second )
     std::swap( first.legacy_computer, second.legacy_computer );
     std::swap( first.temperature, second.temperature );
     std::swap( first.cosmetics, second.cosmetics );
-
-    for( int x = 0; x < SEEX; x++ ) {
-        for( int y = 0; y < SEEY; y++ ) {
-            std::swap( first.itm[x][y], second.itm[x][y] );
-        }
-    }
 }
 
 //There's not a briefer way to write this I don't think
@@ -223,40 +230,89 @@ maptile_soa<sx, sy>::maptile_soa( tripoint offset ) : itm{{
 {
 }
 
-submap::submap( tripoint offset ) : maptile_soa<SEEX, SEEY>( offset )
+template<int sx, int sy>
+static void fill_tiles( maptile_soa<sx, sy> &tiles, const ter_id &terr )
+{
+    std::uninitialized_fill_n( &tiles.ter[0][0], sx * sy, terr );
+    std::uninitialized_fill_n( &tiles.frn[0][0], sx * sy, f_null );
+    std::uninitialized_fill_n( &tiles.lum[0][0], sx * sy, 0 );
+    std::uninitialized_fill_n( &tiles.trp[0][0], sx * sy, tr_null );
+    std::uninitialized_fill_n( &tiles.rad[0][0], sx * sy, 0 );
+}
+
+static std::shared_ptr<const maptile_soa<SEEX, SEEY>> uniform_tiles( const ter_id &terr )
 {
-    std::uninitialized_fill_n( &ter[0][0], elements, t_null );
-    std::uninitialized_fill_n( &frn[0][0], elements, f_null );
-    std::uninitialized_fill_n( &lum[0][0], elements, 0 );
-    std::uninitialized_fill_n( &trp[0][0], elements, tr_null );
-    std::uninitialized_fill_n( &rad[0][0], elements, 0 );
+    // Locked, so that submaps can be created off the main thread
+    static std::mutex cache_mutex;
+    static std::unordered_map<ter_id, std::shared_ptr<const maptile_soa<SEEX, SEEY>>> cache;
+    std::lock_guard<std::mutex> lock( cache_mutex );
+    std::shared_ptr<const maptile_soa<SEEX, SEEY>> &tiles = cache[terr];
+    if( !tiles ) {
+        // The offset doesn't matter, nothing can be put on shared tiles
+        auto new_tiles = std::make_shared<maptile_soa<SEEX, SEEY>>( tripoint_zero );
+        fill_tiles( *new_tiles, terr );
+        tiles = std::move( new_tiles );
+    }
+    return tiles;
+}
+
+submap::submap( tripoint offset ) : offset( offset ),
+    own_tiles( std::make_unique<tile_storage>( offset ) )
+{
+    fill_tiles( *own_tiles, t_null );
 
     is_uniform = false;
 }
 
+submap::submap( tripoint offset, const ter_id &terr ) : offset( offset ),
+    shared_tiles( uniform_tiles( terr ) )
+{
+    is_uniform = true;
+}
+
 submap::~submap() = default;
 
+void submap::unshare_tiles()
+{
+    own_tiles = std::make_unique<tile_storage>( offset );
+    // Items and fields are always empty on shared tiles
+    std::copy_n( &shared_tiles->ter[0][0], elements, &own_tiles->ter[0][0] );
+    std::copy_n( &shared_tiles->frn[0][0], elements, &own_tiles->frn[0][0] );
+    std::copy_n( &shared_tiles->lum[0][0], elements, &own_tiles->lum[0][0] );
+    std::copy_n( &shared_tiles->trp[0][0], elements, &own_tiles->trp[0][0] );
+    std::copy_n( &shared_tiles->rad[0][0], elements, &own_tiles->rad[0][0] );
+    shared_tiles.reset();
+}
+
+void submap::swap_tiles( point p1, point p2 )
+{
+    if( own_tiles ) {
+        own_tiles->swap_soa_tile( p1, p2 );
+    }
+}
+
 void submap::update_lum_rem( point p, const item &i )
 {
     is_uniform = false;
+    std::uint8_t &l = mutable_tiles().lum[p.x][p.y];
     if( !i.is_emissive() ) {
         return;
-    } else if( lum[p.x][p.y] && lum[p.x][p.y] < 255 ) {
-        lum[p.x][p.y]--;
+    } else if( l && l < 255 ) {
+        l--;
         return;
     }
 
     // Have to scan through all items to be sure removing i will actually lower
     // the count below 255.
     int count = 0;
-    for( const auto &it : itm[p.x][p.y] ) {
+    for( const auto &it : tiles().itm[p.x][p.y] ) {
         if( it->is_emissive() ) {
             count++;
         }
     }
 
     if( count <= 256 ) {
-        lum[p.x][p.y] = static_cast<uint8_t>( count - 1 );
+        l = static_cast<uint8_t>( count - 1 );
     }
 }
 
@@ -335,7 +391,7 @@ void submap::delete_graffiti( point p )
 }
 bool submap::has_signage( point p ) const
 {
-    if( frn[p.x][p.y].obj().has_flag( "SIGN" ) ) {
+    if( tiles().frn[p.x][p.y].obj().has_flag( "SIGN" ) ) {
         return find_cosmetic( cosmetics, p, COSMETICS_SIGNAGE ).result;
     }
 
@@ -343,7 +399,7 @@ bool submap::has_signage( point p ) const
 }
 std::string submap::get_signage( point p ) const
 {
-    if( frn[p.x][p.y].obj().has_flag( "SIGN" ) ) {
+    if( tiles().frn[p.x][p.y].obj().has_flag( "SIGN" ) ) {
         const auto fresult = find_cosmetic( cosmetics, p, COSMETICS_SIGNAGE );
         if( fresult.result ) {
             return cosmetics[ fresult.ndx ].str;
@@ -378,7 +434,7 @@ void submap::update_legacy_computer()
     if( legacy_computer ) {
         for( int x = 0; x < SEEX; ++x ) {
             for( int y = 0; y < SEEY; ++y ) {
-                if( ter[x][y] == t_console ) {
+                if( tiles().ter[x][y] == t_console ) {
                     computers.emplace( point( x, y ), *legacy_computer );
                 }
             }
@@ -389,7 +445,7 @@ void submap::update_legacy_computer()
 
 bool submap::has_computer( point p ) const
 {
-    return computers.find( p ) != computers.end() || ( legacy_computer && ter[p.x][p.y] == t_console );
+    return computers.find( p ) != computers.end() || ( legacy_computer && tiles().ter[p.x][p.y] == t_console );
 }
 
 const computer *submap::get_computer( point p ) const
@@ -400,7 +456,7 @@ const computer *submap::get_computer( point p ) const
     if( it != computers.end() ) {
         return &it->second;
     }
-    if( legacy_computer && ter[p.x][p.y] == t_console ) {
+    if( legacy_computer && tiles().ter[p.x][p.y] == t_console ) {
         return legacy_computer.get();
     }
     return nullptr;
@@ -461,14 +517,14 @@ void submap::rotate( int turns )
         // Swap horizontal stripes.
         for( int j = 0, je = SEEY / 2; j < je; ++j ) {
             for( int i = j, ie = SEEX - j; i < ie; ++i ) {
-                swap_soa_tile( { i, j }, rotate_point( { i, j } ) );
+                swap_tiles( { i, j }, rotate_point( { i, j } ) );
             }
         }
         // Swap vertical stripes so that they don't overlap with
         // the already swapped horizontals.
         for( int i = 0, ie = SEEX / 2; i < ie; ++i ) {
             for( int j = i + 1, je = SEEY - i - 1; j < je; ++j ) {
-                swap_soa_tile( { i, j }, rotate_point( { i, j } ) );
+                swap_tiles( { i, j }, rotate_point( { i, j } ) );
             }
         }
     } else {
@@ -500,9 +556,9 @@ void submap::rotate( int turns )
                 point p3 = rotate_point( p2 );
                 point p4 = rotate_point( p3 );
 
-                swap_soa_tile( p1, p2 );
-                swap_soa_tile( p1, p3 );
-                swap_soa_tile( p1, p4 );
+                swap_tiles( p1, p2 );
+                swap_tiles( p1, p3 );
+                swap_tiles( p1, p4 );
             }
         }
     }
@@ -7,6 +7,7 @@
 #include <string>
 #include <iterator>
 #include <map>
+#include <utility>
 
 #include "active_item_cache.h"
 #include "active_tile_data.h"
@@ -29,6 +30,12 @@ struct ter_t;
 struct furn_t;
 class vehicle;
 
+namespace cata
+{
+class binary_reader;
+class binary_writer;
+} // namespace cata
+
 // enum defines the initial disposition of the monster that is to be spawned
 enum class spawn_disposition {
     SpawnDisp_Default,
@@ -68,9 +75,9 @@ struct spawn_point {
 
 template<int sx, int sy>
 struct maptile_soa {
-    protected:
-        maptile_soa( tripoint offset );
     public:
+        explicit maptile_soa( tripoint offset );
+
         ter_id             ter[sx][sy];  // Terrain on each square
         furn_id            frn[sx][sy];  // Furniture on each square
         std::uint8_t       lum[sx][sy];  // Number of items emitting light on each square
@@ -82,73 +89,79 @@ struct maptile_soa {
         void swap_soa_tile( point p1, point p2 );
 };
 
-class submap : maptile_soa<SEEX, SEEY>
+class submap
 {
     public:
         submap( tripoint offset );
+        /**
+         * A uniform submap made of `terr`. Its tiles share one read only storage with all other
+         * uniform submaps of the same terrain, until something writes to them.
+         */
+        submap( tripoint offset, const ter_id &terr );
         ~submap();
 
         trap_id get_trap( point p ) const {
-            return trp[p.x][p.y];
+            return tiles().trp[p.x][p.y];
         }
 
         void set_trap( point p, trap_id trap ) {
             is_uniform = false;
-            trp[p.x][p.y] = trap;
+            mutable_tiles().trp[p.x][p.y] = trap;
         }
 
         void set_all_traps( const trap_id &trap ) {
-            std::uninitialized_fill_n( &trp[0][0], elements, trap );
+            std::uninitialized_fill_n( &mutable_tiles().trp[0][0], elements, trap );
         }
 
         furn_id get_furn( point p ) const {
-            return frn[p.x][p.y];
+            return tiles().frn[p.x][p.y];
         }
 
         void set_furn( point p, furn_id furn ) {
             is_uniform = false;
-            frn[p.x][p.y] = furn;
+            mutable_tiles().frn[p.x][p.y] = furn;
         }
 
         void set_all_furn( const furn_id &furn ) {
-            std::uninitialized_fill_n( &frn[0][0], elements, furn );
+            std::uninitialized_fill_n( &mutable_tiles().frn[0][0], elements, furn );
         }
 
         ter_id get_ter( point p ) const {
-            return ter[p.x][p.y];
+            return tiles().ter[p.x][p.y];
         }
 
         void set_ter( point p, ter_id terr ) {
             is_uniform = false;
-            ter[p.x][p.y] = terr;
+            mutable_tiles().ter[p.x][p.y] = terr;
         }
 
         void set_all_ter( const ter_id &terr ) {
-            std::uninitialized_fill_n( &ter[0][0], elements, terr );
+            std::uninitialized_fill_n( &mutable_tiles().ter[0][0], elements, terr );
         }
 
         int get_radiation( point p ) const {
-            return rad[p.x][p.y];
+            return tiles().rad[p.x][p.y];
         }
 
         void set_radiation( point p, const int radiation ) {
             is_uniform = false;
-            rad[p.x][p.y] = radiation;
+            mutable_tiles().rad[p.x][p.y] = radiation;
         }
 
         uint8_t get_lum( point p ) const {
-            return lum[p.x][p.y];
+            return tiles().lum[p.x][p.y];
         }
 
         void set_lum( point p, uint8_t luminance ) {
             is_uniform = false;
-            lum[p.x][p.y] = luminance;
+            mutable_tiles().lum[p.x][p.y] = luminance;
         }
 
         void update_lum_add( point p, const item &i ) {
             is_uniform = false;
-            if( i.is_emissive() && lum[p.x][p.y] < 255 ) {
-                lum[p.x][p.y]++;
+            std::uint8_t &l = mutable_tiles().lum[p.x][p.y];
+            if( i.is_emissive() && l < 255 ) {
+                l++;
             }
         }
 
@@ -156,20 +169,20 @@ class submap : maptile_soa<SEEX, SEEY>
 
         // TODO: Replace this as it essentially makes itm public
         location_vector<item> &get_items( const point &p ) {
-            return itm[p.x][p.y];
+            return mutable_tiles().itm[p.x][p.y];
         }
 
         const location_vector<item> &get_items( const point &p ) const {
-            return itm[p.x][p.y];
+            return tiles().itm[p.x][p.y];
         }
 
         // TODO: Replace this as it essentially makes fld public
         field &get_field( point p ) {
-            return fld[p.x][p.y];
+            return mutable_tiles().fld[p.x][p.y];
         }
 
         const field &get_field( point p ) const {
-            return fld[p.x][p.y];
+            return tiles().fld[p.x][p.y];
         }
 
         struct cosmetic_t {
@@ -216,10 +229,24 @@ class submap : maptile_soa<SEEX, SEEY>
 
         void store( JsonOut &jsout ) const;
         void load( JsonIn &jsin, const std::string &member_name, int version, const tripoint offset );
+        /**
+         * Same contents as store/load, but terrain, furniture, traps, radiation and fields are
+         * palette and run length encoded binary. Everything else is embedded as JSON.
+         */
+        void store_binary( cata::binary_writer &out ) const;
+        void load_binary( cata::binary_reader &in, int version, const tripoint &offset );
 
         // If is_uniform is true, this submap is a solid block of terrain
         // Uniform submaps aren't saved/loaded, because regenerating them is faster
         bool is_uniform;
+        /** Whether the tiles are still shared with other uniform submaps, see the constructor. */
+        bool shares_tiles() const {
+            return !own_tiles;
+        }
+        /** Memory used by the tiles of a submap that doesn't share them. */
+        static constexpr size_t tile_storage_bytes() {
+            return sizeof( maptile_soa<SEEX, SEEY> );
+        }
 
         std::vector<cosmetic_t> cosmetics; // Textual "visuals" for squares
 
@@ -240,12 +267,39 @@ class submap : maptile_soa<SEEX, SEEY>
         static void swap( submap &first, submap &second );
 
     private:
+        using tile_storage = maptile_soa<SEEX, SEEY>;
+
+        /** Position of the (0,0) tile, item locations need it when the storage gets copied. */
+        tripoint offset;
+        /** Set only while the tiles are shared with other uniform submaps. */
+        std::shared_ptr<const tile_storage> shared_tiles;
+        std::unique_ptr<tile_storage> own_tiles;
+
+        const tile_storage &tiles() const {
+            return own_tiles ? *own_tiles : *shared_tiles;
+        }
+        /** Copies shared tiles into storage of this submap first, if necessary. */
+        tile_storage &mutable_tiles() {
+            if( !own_tiles ) {
+                unshare_tiles();
+            }
+            return *own_tiles;
+        }
+        void unshare_tiles();
+        /** Shared tiles are all the same, so they don't need swapping. */
+        void swap_tiles( point p1, point p2 );
+
         std::map<point, computer> computers;
         std::unique_ptr<computer> legacy_computer;
         int temperature = 0;
 
         void update_legacy_computer();
 
+        /** Vehicles, spawns and other members saved as JSON in both formats. */
+        void store_entities( JsonOut &jsout ) const;
+        void load_item_stack( JsonIn &jsin, point p, int version );
+        void migrate_loaded_items();
+
         static constexpr size_t elements = SEEX * SEEY;
 };
 
@@ -292,7 +346,7 @@ struct maptile {
         }
 
         const field &get_field() const {
-            return sm->get_field( pos() );
+            return std::as_const( *sm ).get_field( pos() );
         }
 
         field_entry *find_field( const field_type_id &field_to_find ) {
@@ -321,12 +375,12 @@ struct maptile {
 
         // For map::draw_maptile
         size_t get_item_count() const {
-            return sm->get_items( pos() ).size();
+            return std::as_const( *sm ).get_items( pos() ).size();
         }
 
         // Assumes there is at least one item
         const item &get_uppermost_item() const {
-            return **std::prev( sm->get_items( pos() ).cend() );
+            return **std::prev( std::as_const( *sm ).get_items( pos() ).cend() );
         }
 };
 
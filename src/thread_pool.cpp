@@ -0,0 +1,87 @@
+#include "thread_pool.h"
+
+thread_pool::thread_pool( size_t num_workers )
+{
+    workers.reserve( num_workers );
+    for( size_t i = 0; i < num_workers; i++ ) {
+        workers.emplace_back( [this]() {
+            worker_loop();
+        } );
+    }
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lk( mutex );
+        stopping = true;
+    }
+    has_jobs.notify_all();
+    for( std::thread &worker : workers ) {
+        worker.join();
+    }
+}
+
+void thread_pool::push( std::move_only_function<void()> &&job )
+{
+    {
+        std::lock_guard<std::mutex> lk( mutex );
+        jobs.push_back( std::move( job ) );
+    }
+    has_jobs.notify_one();
+}
+
+void thread_pool::worker_loop()
+{
+    while( true ) {
+        std::move_only_function<void()> job;
+        {
+            std::unique_lock<std::mutex> lk( mutex );
+            has_jobs.wait( lk, [this]() {
+                return stopping || !jobs.empty();
+            } );
+            // Finish whatever is queued even when stopping, someone may be waiting on it
+            if( jobs.empty() ) {
+                return;
+            }
+            job = std::move( jobs.front() );
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+
+void thread_pool::parallel_for_state::run()
+{
+    for( int i = next++; i < end; i = next++ ) {
+        try {
+            call( i );
+        } catch( ... ) {
+            std::lock_guard<std::mutex> lk( mutex );
+            if( !error ) {
+                error = std::current_exception();
+            }
+        }
+        std::lock_guard<std::mutex> lk( mutex );
+        if( --remaining == 0 ) {
+            done.notify_all();
+        }
+    }
+}
+
+void thread_pool::parallel_for_state::wait()
+{
+    std::unique_lock<std::mutex> lk( mutex );
+    done.wait( lk, [this]() {
+        return remaining == 0;
+    } );
+    if( error ) {
+        std::rethrow_exception( error );
+    }
+}
+
+thread_pool &get_thread_pool()
+{
+    static thread_pool pool( std::max( 1u, std::thread::hardware_concurrency() ) - 1 );
+    return pool;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Fixed set of worker threads for short jobs that would otherwise be run one after another
+ * on the main thread, e.g. building caches for every z-level.
+ *
+ * Jobs must not touch UI, Lua or anything else that expects to be on the main thread.
+ */
+class thread_pool
+{
+    public:
+        explicit thread_pool( size_t num_workers );
+        thread_pool( const thread_pool & ) = delete;
+        thread_pool &operator=( const thread_pool & ) = delete;
+        ~thread_pool();
+
+        size_t num_workers() const {
+            return workers.size();
+        }
+
+        /** Queue `job` to be run by one of the workers. */
+        template<typename Job>
+        auto submit( Job &&job ) -> std::future<std::invoke_result_t<Job>> {
+            using result_t = std::invoke_result_t<Job>;
+            std::packaged_task<result_t()> task( std::forward<Job>( job ) );
+            std::future<result_t> result = task.get_future();
+            if( workers.empty() ) {
+                task();
+            } else {
+                push( [t = std::move( task )]() mutable {
+                    t();
+                } );
+            }
+            return result;
+        }
+
+        /**
+         * Call `fn( i )` for every i in [begin, end) and wait for all of them to finish.
+         * The calling thread takes part in the work, so this is safe to call from within a job.
+         * Order of calls is unspecified, the first exception thrown is rethrown here once all calls are done.
+         * If `parallel` is false, or there are no workers, the calls are made in order on the calling thread.
+         */
+        template<typename Fn>
+        void parallel_for( int begin, int end, Fn &&fn, bool parallel = true ) {
+            if( end <= begin ) {
+                return;
+            }
+            if( !parallel || workers.empty() || end - begin == 1 ) {
+                for( int i = begin; i < end; i++ ) {
+                    fn( i );
+                }
+                return;
+            }
+
+            // Helpers may only get to run after the calling thread has done all the work and returned,
+            //   so `fn` is only called through the state after claiming an index that isn't done yet
+            auto state = std::make_shared<parallel_for_state>( begin, end, std::ref( fn ) );
+            const size_t num_helpers = std::min<size_t>( workers.size(), end - begin - 1 );
+            for( size_t i = 0; i < num_helpers; i++ ) {
+                push( [state]() {
+                    state->run();
+                } );
+            }
+            state->run();
+            state->wait();
+        }
+
+    private:
+        struct parallel_for_state {
+            parallel_for_state( int begin, int end, std::function<void( int )> &&fn ) :
+                call( std::move( fn ) ), next( begin ), end( end ), remaining( end - begin ) {}
+
+            void run();
+            void wait();
+
+            const std::function<void( int )> call;
+            std::atomic<int> next;
+            const int end;
+            int remaining;
+            std::exception_ptr error;
+            std::mutex mutex;
+            std::condition_variable done;
+        };
+
+        void push( std::move_only_function<void()> &&job );
+        void worker_loop();
+
+        std::vector<std::thread> workers;
+        std::deque<std::move_only_function<void()>> jobs;
+        std::mutex mutex;
+        std::condition_variable has_jobs;
+        bool stopping = false;
+};
+
+/** Pool shared by the whole game, with one worker less than there are hardware threads. */
+thread_pool &get_thread_pool();
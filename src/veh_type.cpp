@@ -517,27 +517,43 @@ void vpart_info::finalize()
             info.z_order = 0;
             info.list_order = 5;
         }
-    }
-}
 
-void vpart_info::check()
-{
-    for( auto &vp : vpart_info_all ) {
-        auto &part = vp.second;
+        // Everything below changes the data, so it can't wait for check(),
+        // which is skipped for data that passed it before
 
         // add the base item to the installation requirements
         // TODO: support multiple/alternative base items
         requirement_data ins;
-        ins.components.push_back( { { { part.item, 1 } } } );
+        ins.components.push_back( { { { info.item, 1 } } } );
 
-        const requirement_id ins_id( std::string( "inline_vehins_base_" ) + part.id.str() );
+        const requirement_id ins_id( std::string( "inline_vehins_base_" ) + info.id.str() );
         requirement_data::save_requirement( ins, ins_id );
-        part.install_reqs.emplace_back( ins_id, 1 );
+        info.install_reqs.emplace_back( ins_id, 1 );
 
-        if( part.removal_moves < 0 ) {
-            part.removal_moves = part.install_moves / 2;
+        if( info.removal_moves < 0 ) {
+            info.removal_moves = info.install_moves / 2;
         }
 
+        // Fuel type errors are serious and need fixing now
+        if( !info.fuel_type.is_valid() ) {
+            debugmsg( "vehicle part %s uses undefined fuel %s", info.id.c_str(), info.item.c_str() );
+            info.fuel_type = itype_id::NULL_ID();
+        } else if( info.fuel_type && !info.fuel_type->fuel && info.item.is_valid() &&
+                   ( !info.item->container || !info.item->container->watertight ) ) {
+            // HACK: Tanks are allowed to specify non-fuel "fuel",
+            // because currently legacy blazemod uses it as a hack to restrict content types
+            debugmsg( "non-tank vehicle part %s uses non-fuel item %s as fuel, setting to null",
+                      info.id.c_str(), info.fuel_type.c_str() );
+            info.fuel_type = itype_id::NULL_ID();
+        }
+    }
+}
+
+void vpart_info::check()
+{
+    for( auto &vp : vpart_info_all ) {
+        auto &part = vp.second;
+
         for( const auto &[skill, level] : part.install_skills ) {
             if( !skill.is_valid() ) {
                 debugmsg( "vehicle part %s has unknown install skill %s", part.id.c_str(), skill.c_str() );
@@ -617,18 +633,6 @@ void vpart_info::check()
             debugmsg( "vehicle part %s uses undefined item %s", part.id.c_str(), part.item.c_str() );
         }
         const itype &base_item_type = *part.item;
-        // Fuel type errors are serious and need fixing now
-        if( !part.fuel_type.is_valid() ) {
-            debugmsg( "vehicle part %s uses undefined fuel %s", part.id.c_str(), part.item.c_str() );
-            part.fuel_type = itype_id::NULL_ID();
-        } else if( part.fuel_type && !part.fuel_type->fuel &&
-                   ( !base_item_type.container || !base_item_type.container->watertight ) ) {
-            // HACK: Tanks are allowed to specify non-fuel "fuel",
-            // because currently legacy blazemod uses it as a hack to restrict content types
-            debugmsg( "non-tank vehicle part %s uses non-fuel item %s as fuel, setting to null",
-                      part.id.c_str(), part.fuel_type.c_str() );
-            part.fuel_type = itype_id::NULL_ID();
-        }
         if( part.has_flag( "TURRET" ) && !base_item_type.gun ) {
             debugmsg( "vehicle part %s has the TURRET flag, but is not made from a gun item", part.id.c_str() );
         }
@@ -2,8 +2,10 @@
 
 #include <algorithm>
 #include <sstream>
+#include <cstdio>
 #include <cstring>
 #include <chrono>
+#include <iterator>
 
 #include "game.h"
 #include "avatar.h"
@@ -16,6 +18,7 @@
 #include "path_info.h"
 #include "compress.h"
 #include "sqlite3.h"
+#include "thread_pool.h"
 #include "zlib.h"
 
 #define dbg(x) DebugLogFL((x),DC::Main)
@@ -30,7 +33,9 @@ static sqlite3 *open_db( const std::string &path )
         throw std::runtime_error( "Failed to initialize sqlite3" );
     }
 
-    ret = sqlite3_open_v2( path.c_str(), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL );
+    // Serialized, the save writer and map prefetching use the connections from their own threads
+    ret = sqlite3_open_v2( path.c_str(), &db,
+                           SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, NULL );
     if( ret != SQLITE_OK ) {
         dbg( DL::Error ) << "Failed to open db" << path << " (Error " << ret << ")";
         throw std::runtime_error( "Failed to open db" );
@@ -52,6 +57,15 @@ static sqlite3 *open_db( const std::string &path )
         throw std::runtime_error( "Failed to open db" );
     }
 
+    // Each save is one big transaction, with WAL committing it only appends to the log instead
+    // of journaling every page it touches. NORMAL sync is still safe against corruption in WAL mode.
+    ret = sqlite3_exec( db, "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;", NULL, NULL,
+                        &sqlErrMsg );
+    if( ret != SQLITE_OK ) {
+        dbg( DL::Warn ) << "Failed to enable WAL for db" << path << " (" << sqlErrMsg << ")";
+        sqlite3_free( sqlErrMsg );
+    }
+
     return db;
 }
 
@@ -267,99 +281,152 @@ void load_external_option( const JsonObject &jo )
     }
 }
 
-static bool file_exist_in_db( sqlite3 *db, const std::string &path )
+static sqlite3_stmt *prepare_statement( sqlite3 *db, const char *sql )
 {
-    int fileCount = 0;
-    const char *sql = "SELECT count() FROM files WHERE path = :path";
     sqlite3_stmt *stmt = nullptr;
-
-    if( sqlite3_prepare_v2( db, sql, -1, &stmt, nullptr ) != SQLITE_OK ) {
+    if( sqlite3_prepare_v3( db, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr ) != SQLITE_OK ) {
         dbg( DL::Error ) << "Failed to prepare statement: " << sqlite3_errmsg( db ) << '\n';
         throw std::runtime_error( "DB query failed" );
     }
+    return stmt;
+}
+
+static db_statements prepare_statements( sqlite3 *db )
+{
+    db_statements stmts;
+    stmts.exists = prepare_statement( db, "SELECT count() FROM files WHERE path = :path" );
+    stmts.read = prepare_statement( db,
+                                    "SELECT data, compression FROM files WHERE path = :path LIMIT 1" );
+    stmts.write = prepare_statement( db, R"sql(
+        INSERT INTO files(path, parent, data, compression)
+        VALUES (:path, :parent, :data, :compression)
+        ON CONFLICT(path) DO UPDATE
+            SET data = excluded.data,
+                parent = excluded.parent,
+                compression = excluded.compression;
+    )sql" );
+    return stmts;
+}
+
+static void finalize_statements( db_statements &stmts )
+{
+    sqlite3_finalize( stmts.exists );
+    sqlite3_finalize( stmts.read );
+    sqlite3_finalize( stmts.write );
+    stmts = db_statements();
+}
+
+namespace
+{
+/** Makes a cached statement ready for the next use, however the current one ends. */
+class statement_reset
+{
+    public:
+        explicit statement_reset( sqlite3_stmt *stmt ) : stmt( stmt ) {}
+        statement_reset( const statement_reset & ) = delete;
+        statement_reset &operator=( const statement_reset & ) = delete;
+        ~statement_reset() {
+            sqlite3_reset( stmt );
+            sqlite3_clear_bindings( stmt );
+        }
+    private:
+        sqlite3_stmt *stmt;
+};
+} // namespace
+
+static bool file_exist_in_db( sqlite3 *db, sqlite3_stmt *stmt, const std::string &path )
+{
+    statement_reset reset( stmt );
 
     if( sqlite3_bind_text( stmt, sqlite3_bind_parameter_index( stmt, ":path" ), path.c_str(), -1,
                            SQLITE_TRANSIENT ) != SQLITE_OK ) {
         dbg( DL::Error ) << "Failed to bind parameter: " << sqlite3_errmsg( db ) << '\n';
-        sqlite3_finalize( stmt );
         throw std::runtime_error( "DB query failed" );
     }
 
-    if( sqlite3_step( stmt ) == SQLITE_ROW ) {
-        // Retrieve the count result
-        fileCount = sqlite3_column_int( stmt, 0 );
-    } else {
+    if( sqlite3_step( stmt ) != SQLITE_ROW ) {
         dbg( DL::Error ) << "Failed to execute query: " << sqlite3_errmsg( db ) << '\n';
-        sqlite3_finalize( stmt );
         throw std::runtime_error( "DB query failed" );
     }
+    // Retrieve the count result
+    return sqlite3_column_int( stmt, 0 ) > 0;
+}
 
-    sqlite3_finalize( stmt );
-
-    return fileCount > 0;
+static void exec_statement( sqlite3 *db, const char *sql )
+{
+    char *sqlErrMsg = nullptr;
+    if( sqlite3_exec( db, sql, NULL, NULL, &sqlErrMsg ) != SQLITE_OK ) {
+        dbg( DL::Error ) << "Failed to execute " << sql << ": " << ( sqlErrMsg ? sqlErrMsg : "" ) << '\n';
+        sqlite3_free( sqlErrMsg );
+        throw std::runtime_error( "DB query failed" );
+    }
 }
 
-static void write_to_db( sqlite3 *db, const std::string &path, file_write_fn writer )
+static void remove_from_db( sqlite3 *db, sqlite3_stmt *stmt, const std::string &path )
 {
-    std::ostringstream oss;
-    writer( oss );
-    auto data = oss.str();
+    statement_reset reset( stmt );
+
+    if( sqlite3_bind_text( stmt, sqlite3_bind_parameter_index( stmt, ":path" ), path.c_str(), -1,
+                           SQLITE_TRANSIENT ) != SQLITE_OK ) {
+        dbg( DL::Error ) << "Failed to bind parameter: " << sqlite3_errmsg( db ) << '\n';
+        throw std::runtime_error( "DB query failed" );
+    }
 
+    if( sqlite3_step( stmt ) != SQLITE_DONE ) {
+        dbg( DL::Error ) << "Failed to execute query: " << sqlite3_errmsg( db ) << '\n';
+        throw std::runtime_error( "DB query failed" );
+    }
+}
+
+static void write_data_to_db( sqlite3 *db, sqlite3_stmt *stmt, const std::string &path,
+                              const std::string &data, compression_kind kind, save_tx_stats &stats )
+{
     std::vector<std::byte> compressedData;
-    zlib_compress( data, compressedData );
+    zlib_dict_compress( data, kind, compressedData );
 
     size_t basePos = path.find_last_of( "/\\" );
     auto parent = ( basePos == std::string::npos ) ? "" : path.substr( 0, basePos );
 
-    auto sql = R"sql(
-        INSERT INTO files(path, parent, data, compression)
-        VALUES (:path, :parent, :data, 'zlib')
-        ON CONFLICT(path) DO UPDATE
-            SET data = excluded.data,
-                parent = excluded.parent,
-                compression = excluded.compression;
-    )sql";
-
-    sqlite3_stmt *stmt = nullptr;
-
-    if( sqlite3_prepare_v2( db, sql, -1, &stmt, nullptr ) != SQLITE_OK ) {
-        dbg( DL::Error ) << "Failed to prepare statement: " << sqlite3_errmsg( db ) << '\n';
-        throw std::runtime_error( "DB query failed" );
-    }
+    statement_reset reset( stmt );
 
+    // Strings outlive the step, so no need for sqlite to copy them
     if( sqlite3_bind_text( stmt, sqlite3_bind_parameter_index( stmt, ":path" ), path.c_str(), -1,
-                           SQLITE_TRANSIENT ) != SQLITE_OK ||
+                           SQLITE_STATIC ) != SQLITE_OK ||
         sqlite3_bind_text( stmt, sqlite3_bind_parameter_index( stmt, ":parent" ), parent.c_str(), -1,
-                           SQLITE_TRANSIENT ) != SQLITE_OK ||
+                           SQLITE_STATIC ) != SQLITE_OK ||
         sqlite3_bind_blob( stmt, sqlite3_bind_parameter_index( stmt, ":data" ), compressedData.data(),
-                           compressedData.size(), SQLITE_TRANSIENT ) != SQLITE_OK ) {
+                           compressedData.size(), SQLITE_STATIC ) != SQLITE_OK ||
+        sqlite3_bind_text( stmt, sqlite3_bind_parameter_index( stmt, ":compression" ), zlib_dict_codec,
+                           -1, SQLITE_STATIC ) != SQLITE_OK ) {
         dbg( DL::Error ) << "Failed to bind parameters: " << sqlite3_errmsg( db ) << '\n';
-        sqlite3_finalize( stmt );
         throw std::runtime_error( "DB query failed" );
     }
 
     if( sqlite3_step( stmt ) != SQLITE_DONE ) {
         dbg( DL::Error ) << "Failed to execute query: " << sqlite3_errmsg( db ) << '\n';
+        throw std::runtime_error( "DB query failed" );
     }
-    sqlite3_finalize( stmt );
+    stats.rows_written++;
+    stats.bytes_uncompressed += data.size();
+    stats.bytes_compressed += compressedData.size();
 }
 
-static bool read_from_db( sqlite3 *db, const std::string &path, file_read_fn reader,
-                          bool optional )
+static void write_to_db( sqlite3 *db, sqlite3_stmt *stmt, const std::string &path,
+                         file_write_fn writer, compression_kind kind, save_tx_stats &stats )
 {
-    const char *sql = "SELECT data, compression FROM files WHERE path = :path LIMIT 1";
-
-    sqlite3_stmt *stmt = nullptr;
+    std::ostringstream oss;
+    writer( oss );
+    write_data_to_db( db, stmt, path, oss.str(), kind, stats );
+}
 
-    if( sqlite3_prepare_v2( db, sql, -1, &stmt, nullptr ) != SQLITE_OK ) {
-        dbg( DL::Error ) << "Failed to prepare statement: " << sqlite3_errmsg( db ) << '\n';
-        throw std::runtime_error( "DB query failed" );
-    }
+static std::optional<std::string> read_data_from_db( sqlite3 *db, sqlite3_stmt *stmt,
+        const std::string &path, bool optional )
+{
+    statement_reset reset( stmt );
 
     if( sqlite3_bind_text( stmt, sqlite3_bind_parameter_index( stmt, ":path" ), path.c_str(), -1,
                            SQLITE_TRANSIENT ) != SQLITE_OK ) {
         dbg( DL::Error ) << "Failed to bind parameter: " << sqlite3_errmsg( db ) << '\n';
-        sqlite3_finalize( stmt );
         throw std::runtime_error( "DB query failed" );
     }
 
@@ -371,39 +438,46 @@ static bool read_from_db( sqlite3 *db, const std::string &path, file_read_fn rea
         std::string compression = compression_raw ? reinterpret_cast<const char *>( compression_raw ) : "";
 
         if( blobData == nullptr ) {
-            return false; // Return an empty string if there's no data
+            return std::nullopt;
         }
 
         std::string dataString;
         if( compression.empty() ) {
             dataString = std::string( static_cast<const char *>( blobData ), blobSize );
+        } else if( compression == zlib_dict_codec ) {
+            zlib_dict_decompress( blobData, blobSize, dataString );
         } else if( compression == "zlib" ) {
+            // Written before dictionaries were used
             zlib_decompress( blobData, blobSize, dataString );
         } else {
             throw std::runtime_error( "Unknown compression format: " + compression );
         }
-
-        std::istringstream stream( dataString );
-        reader( stream );
-        sqlite3_finalize( stmt );
+        return dataString;
     } else {
-        auto err = sqlite3_errmsg( db );
-        sqlite3_finalize( stmt );
-
         if( !optional ) {
-            dbg( DL::Error ) << "Failed to execute query: " << err << '\n';
+            dbg( DL::Error ) << "Failed to execute query: " << sqlite3_errmsg( db ) << '\n';
             throw std::runtime_error( "DB query failed" );
         }
-        return false;
+        return std::nullopt;
     }
+}
 
+static bool read_from_db( sqlite3 *db, sqlite3_stmt *stmt, const std::string &path,
+                          file_read_fn reader, bool optional )
+{
+    const std::optional<std::string> data = read_data_from_db( db, stmt, path, optional );
+    if( !data ) {
+        return false;
+    }
+    std::istringstream stream( *data );
+    reader( stream );
     return true;
 }
 
-static bool read_from_db_json( sqlite3 *db, const std::string &path, file_read_json_fn reader,
-                               bool optional )
+static bool read_from_db_json( sqlite3 *db, sqlite3_stmt *stmt, const std::string &path,
+                               file_read_json_fn reader, bool optional )
 {
-    return read_from_db( db, path, [&]( std::istream & fin ) {
+    return read_from_db( db, stmt, path, [&]( std::istream & fin ) {
         JsonIn jsin( fin, path );
         reader( jsin );
     }, optional );
@@ -419,10 +493,35 @@ world::world( WORLDINFO *info )
 
     if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
         map_db = open_db( info->folder_path() + "/map.sqlite3" );
+        map_db_statements = prepare_statements( map_db );
+        prefetch_read = prepare_statement( map_db,
+                                           "SELECT data, compression FROM files WHERE path = :path LIMIT 1" );
+        // Evicted quads left by a game that ended without saving are dropped
+        exec_statement( map_db, R"sql(
+            CREATE TABLE IF NOT EXISTS evicted_files (
+                path           TEXT PRIMARY KEY NOT NULL,
+                parent         TEXT NOT NULL,
+                compression    TEXT DEFAULT NULL,
+                data           BLOB NOT NULL
+            );
+            DELETE FROM evicted_files;
+        )sql" );
+        evicted_statements.read = prepare_statement( map_db,
+                                  "SELECT data, compression FROM evicted_files WHERE path = :path LIMIT 1" );
+        evicted_statements.write = prepare_statement( map_db, R"sql(
+            INSERT INTO evicted_files(path, parent, data, compression)
+            VALUES (:path, :parent, :data, :compression)
+            ON CONFLICT(path) DO UPDATE
+                SET data = excluded.data,
+                    parent = excluded.parent,
+                    compression = excluded.compression;
+        )sql" );
+        evicted_remove = prepare_statement( map_db, "DELETE FROM evicted_files WHERE path = :path" );
     } else {
         if( !assure_dir_exist( "/maps" ) ) {
             dbg( DL::Error ) << "Unable to create or open world directory structure: " << info->folder_path();
         }
+        remove_tree( info->folder_path() + "/maps_evicted" );
     }
 }
 
@@ -432,30 +531,56 @@ world::~world()
         dbg( DL::Error ) << "Save transaction was not committed before world destruction";
     }
 
+    // Finishes whatever is still queued before the databases are closed
+    wait_for_queued_writes();
+    save_writer.reset();
+    // Likewise for prefetches
+    map_reader.reset();
+
     if( map_db ) {
+        sqlite3_finalize( prefetch_read );
+        finalize_statements( map_db_statements );
+        finalize_statements( evicted_statements );
+        sqlite3_finalize( evicted_remove );
         sqlite3_close( map_db );
     }
 
     if( save_db ) {
+        finalize_statements( save_db_statements );
         sqlite3_close( save_db );
     }
 }
 
+static int64_t now_ms()
+{
+    return std::chrono::duration_cast< std::chrono::milliseconds >(
+               std::chrono::system_clock::now().time_since_epoch()
+           ).count();
+}
+
 void world::start_save_tx()
 {
     if( save_tx_start_ts != 0 ) {
         throw std::runtime_error( "Attempted to start a save transaction while one was already in progress" );
     }
-    save_tx_start_ts = std::chrono::duration_cast< std::chrono::milliseconds >(
-                           std::chrono::system_clock::now().time_since_epoch()
-                       ).count();
+    save_tx_start_ts = now_ms();
+
+    background_save_tx = map_db && get_option<bool>( "BACKGROUND_SAVE" );
+    if( background_save_tx && !save_writer ) {
+        save_writer = std::make_unique<thread_pool>( 1 );
+    }
+
+    run_in_save_order( [this]() {
+        current_save_stats = save_tx_stats();
+    } );
 
     if( map_db ) {
-        sqlite3_exec( map_db, "BEGIN TRANSACTION", NULL, NULL, NULL );
+        exec_in_save_order( map_db, "BEGIN TRANSACTION" );
     }
 
+    // The player database may only be opened during the save, get_player_db begins it then
     if( save_db ) {
-        sqlite3_exec( save_db, "BEGIN TRANSACTION", NULL, NULL, NULL );
+        exec_in_save_order( save_db, "BEGIN TRANSACTION" );
     }
 }
 
@@ -464,23 +589,104 @@ int64_t world::commit_save_tx()
     if( save_tx_start_ts == 0 ) {
         throw std::runtime_error( "Attempted to commit a save transaction while none was in progress" );
     }
+    // The save is over even if committing it failed, so the next one can start
+    on_out_of_scope end_tx( [this]() {
+        save_tx_start_ts = 0;
+        background_save_tx = false;
+    } );
 
     if( map_db ) {
-        sqlite3_exec( map_db, "COMMIT", NULL, NULL, NULL );
+        exec_in_save_order( map_db, "COMMIT" );
     }
 
     if( save_db ) {
-        sqlite3_exec( save_db, "COMMIT", NULL, NULL, NULL );
+        exec_in_save_order( save_db, "COMMIT" );
     }
 
-    int64_t now = std::chrono::duration_cast< std::chrono::milliseconds >(
-                      std::chrono::system_clock::now().time_since_epoch()
-                  ).count();
-    int64_t duration = now - save_tx_start_ts;
-    save_tx_start_ts = 0;
+    int64_t duration = now_ms() - save_tx_start_ts;
+    run_in_save_order( [this, start = save_tx_start_ts, duration]() {
+        current_save_stats.wall_time_ms = now_ms() - start;
+        last_save_stats_ = current_save_stats;
+        dbg( DL::Info ) << "Saved " << last_save_stats_.rows_written << " rows, "
+                        << last_save_stats_.bytes_uncompressed << " bytes compressed to "
+                        << last_save_stats_.bytes_compressed << ", in " << last_save_stats_.wall_time_ms
+                        << "ms with the main thread stalled for " << duration << "ms";
+    } );
     return duration;
 }
 
+bool world::wait_for_pending_writes() const
+{
+    wait_for_queued_writes();
+    return !queued_write_failed.exchange( false );
+}
+
+save_tx_stats world::last_save_stats() const
+{
+    wait_for_queued_writes();
+    return last_save_stats_;
+}
+
+void world::wait_for_queued_writes() const
+{
+    if( last_queued_write.valid() ) {
+        last_queued_write.get();
+    }
+}
+
+void world::queue_save_job( std::function<void()> job ) const
+{
+    last_queued_write = save_writer->submit( [this, job = std::move( job )]() {
+        try {
+            job();
+        } catch( const std::exception &err ) {
+            dbg( DL::Error ) << "Failed to write save data: " << err.what();
+            queued_write_failed = true;
+        }
+    } ).share();
+}
+
+void world::run_in_save_order( std::function<void()> job ) const
+{
+    if( background_save_tx ) {
+        queue_save_job( std::move( job ) );
+    } else {
+        // Can't overtake anything still queued from the last save
+        wait_for_queued_writes();
+        job();
+    }
+}
+
+void world::exec_in_save_order( sqlite3 *db, const char *sql ) const
+{
+    run_in_save_order( [db, sql]() {
+        exec_statement( db, sql );
+    } );
+}
+
+const db_statements &world::statements_for( sqlite3 *db ) const
+{
+    return db == map_db ? map_db_statements : save_db_statements;
+}
+
+void world::write_to_db_in_save_order( sqlite3 *db, const std::string &path,
+                                       file_write_fn writer, compression_kind kind ) const
+{
+    sqlite3_stmt *stmt = statements_for( db ).write;
+    if( !background_save_tx ) {
+        run_in_save_order( [&]() {
+            write_to_db( db, stmt, path, writer, kind, current_save_stats );
+        } );
+        return;
+    }
+    // Serializing is the snapshot, it has to happen now while the game state is consistent
+    std::ostringstream oss;
+    writer( oss );
+    queue_save_job( [this, db, stmt, path, kind, data = oss.str()]() {
+        write_data_to_db( db, stmt, path, data, kind, current_save_stats );
+    } );
+}
+
 /**
  * DOMAIN SPECIFIC: MAP
  */
@@ -496,14 +702,15 @@ static std::string get_quad_filename( const tripoint &om_addr )
     return string_format( "%d.%d.%d.map", om_addr.x, om_addr.y, om_addr.z );
 }
 
-bool world::read_map_quad( const tripoint &om_addr, file_read_json_fn reader ) const
+bool world::read_map_quad( const tripoint &om_addr, file_read_fn reader ) const
 {
     const std::string dirname = get_quad_dirname( om_addr );
     std::string quad_path = dirname + "/" + get_quad_filename( om_addr );
 
     // V2 logic
     if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
-        return read_from_db_json( map_db, quad_path, reader, true );
+        wait_for_queued_writes();
+        return read_from_db( map_db, map_db_statements.read, quad_path, reader, true );
     } else {
         if( !file_exist( quad_path ) ) {
             // Fix for old saves where the path was generated using std::stringstream, which
@@ -517,8 +724,26 @@ bool world::read_map_quad( const tripoint &om_addr, file_read_json_fn reader ) c
             }
         }
 
-        return read_from_file_json( quad_path, reader, true );
+        return read_from_file( quad_path, reader, true );
+    }
+}
+
+std::future<std::optional<std::string>> world::prefetch_map_quad( const tripoint &om_addr ) const
+{
+    if( info->world_save_format != save_format::V2_COMPRESSED_SQLITE3 ) {
+        return {};
     }
+    if( !map_reader ) {
+        map_reader = std::make_unique<thread_pool>( 1 );
+    }
+    const std::string quad_path = get_quad_dirname( om_addr ) + "/" + get_quad_filename( om_addr );
+    // Has to see everything written before it was requested, like a read on this thread would
+    return map_reader->submit( [this, quad_path, after = last_queued_write]() {
+        if( after.valid() ) {
+            after.wait();
+        }
+        return read_data_from_db( map_db, prefetch_read, quad_path, true );
+    } );
 }
 
 bool world::write_map_quad( const tripoint &om_addr, file_write_fn writer ) const
@@ -528,7 +753,7 @@ bool world::write_map_quad( const tripoint &om_addr, file_write_fn writer ) cons
 
     // V2 logic
     if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
-        write_to_db( map_db, quad_path, writer );
+        write_to_db_in_save_order( map_db, quad_path, writer, compression_kind::map_quad );
         return true;
     } else {
         assure_dir_exist( dirname );
@@ -536,6 +761,100 @@ bool world::write_map_quad( const tripoint &om_addr, file_write_fn writer ) cons
     }
 }
 
+static std::string get_evicted_quad_path( const tripoint &om_addr )
+{
+    return "maps_evicted/" + get_quad_filename( om_addr );
+}
+
+bool world::write_evicted_map_quad( const tripoint &om_addr, const std::string &data ) const
+{
+    if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
+        // Same path as in the files table, so saving only has to copy the rows over
+        const std::string quad_path = get_quad_dirname( om_addr ) + "/" + get_quad_filename( om_addr );
+        // Not part of any save, so not counted in one
+        save_tx_stats not_saved;
+        try {
+            wait_for_queued_writes();
+            write_data_to_db( map_db, evicted_statements.write, quad_path, data,
+                              compression_kind::map_quad, not_saved );
+        } catch( const std::exception &err ) {
+            dbg( DL::Error ) << "Failed to write evicted map quad " << quad_path << ": " << err.what();
+            return false;
+        }
+        return true;
+    } else {
+        assure_dir_exist( "maps_evicted" );
+        return write_to_file( get_evicted_quad_path( om_addr ), [&]( std::ostream & fout ) {
+            fout.write( data.data(), data.size() );
+        }, "" );
+    }
+}
+
+std::optional<std::string> world::take_evicted_map_quad( const tripoint &om_addr ) const
+{
+    if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
+        const std::string quad_path = get_quad_dirname( om_addr ) + "/" + get_quad_filename( om_addr );
+        wait_for_queued_writes();
+        std::optional<std::string> data = read_data_from_db( map_db, evicted_statements.read, quad_path,
+                                          true );
+        if( data ) {
+            remove_from_db( map_db, evicted_remove, quad_path );
+        }
+        return data;
+    } else {
+        const std::string path = get_evicted_quad_path( om_addr );
+        std::optional<std::string> data;
+        read_from_file( path, [&]( std::istream & fin ) {
+            data.emplace( std::istreambuf_iterator<char>( fin ), std::istreambuf_iterator<char>() );
+        }, true );
+        if( data ) {
+            remove_file( info->folder_path() + "/" + path );
+        }
+        return data;
+    }
+}
+
+void world::save_evicted_map_quads() const
+{
+    if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
+        // WHERE true tells SQLite the ON CONFLICT isn't part of a join
+        exec_in_save_order( map_db, R"sql(
+            INSERT INTO files(path, parent, data, compression)
+            SELECT path, parent, data, compression FROM evicted_files WHERE true
+            ON CONFLICT(path) DO UPDATE
+                SET data = excluded.data,
+                    parent = excluded.parent,
+                    compression = excluded.compression;
+            DELETE FROM evicted_files;
+        )sql" );
+    } else {
+        const std::string evicted_dir = info->folder_path() + "/maps_evicted";
+        for( const std::string &path : get_files_from_path( ".map", evicted_dir, false, true ) ) {
+            const std::string filename = path.substr( path.find_last_of( "/\\" ) + 1 );
+            tripoint om_addr;
+            if( std::sscanf( filename.c_str(), "%d.%d.%d.map", &om_addr.x, &om_addr.y,
+                             &om_addr.z ) != 3 ) {
+                continue;
+            }
+            const std::string dirname = get_quad_dirname( om_addr );
+            assure_dir_exist( dirname );
+            if( !rename_file( path, info->folder_path() + "/" + dirname + "/" + filename ) ) {
+                throw std::runtime_error( "Failed to save evicted map quad " + filename );
+            }
+        }
+    }
+}
+
+void world::discard_evicted_map_quads() const
+{
+    if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
+        wait_for_queued_writes();
+        exec_statement( map_db, "DELETE FROM evicted_files" );
+    } else {
+        remove_tree( info->folder_path() + "/maps_evicted" );
+    }
+}
+
 /**
  * DOMAIN SPECIFIC: OVERMAP
  */
@@ -553,7 +872,8 @@ std::string world::overmap_player_filename( const point_abs_om &p ) const
 bool world::overmap_exists( const point_abs_om &p ) const
 {
     if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
-        return file_exist_in_db( map_db, overmap_terrain_filename( p ) );
+        wait_for_queued_writes();
+        return file_exist_in_db( map_db, map_db_statements.exists, overmap_terrain_filename( p ) );
     } else {
         return file_exist( overmap_terrain_filename( p ) );
     }
@@ -562,7 +882,9 @@ bool world::overmap_exists( const point_abs_om &p ) const
 bool world::read_overmap( const point_abs_om &p, file_read_fn reader ) const
 {
     if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
-        return read_from_db( map_db, overmap_terrain_filename( p ), reader, true );
+        wait_for_queued_writes();
+        return read_from_db( map_db, map_db_statements.read, overmap_terrain_filename( p ), reader,
+                             true );
     } else {
         return read_from_file( overmap_terrain_filename( p ), reader, true );
     }
@@ -571,8 +893,10 @@ bool world::read_overmap( const point_abs_om &p, file_read_fn reader ) const
 bool world::read_overmap_player_visibility( const point_abs_om &p, file_read_fn reader )
 {
     if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
+        wait_for_queued_writes();
         sqlite3 *playerdb = get_player_db();
-        return read_from_db( playerdb, overmap_player_filename( p ), reader, true );
+        return read_from_db( playerdb, save_db_statements.read, overmap_player_filename( p ), reader,
+                             true );
     } else {
         return read_from_player_file( overmap_player_filename( p ), reader, true );
     }
@@ -581,7 +905,8 @@ bool world::read_overmap_player_visibility( const point_abs_om &p, file_read_fn
 bool world::write_overmap( const point_abs_om &p, file_write_fn writer ) const
 {
     if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
-        write_to_db( map_db, overmap_terrain_filename( p ), writer );
+        write_to_db_in_save_order( map_db, overmap_terrain_filename( p ), writer,
+                                   compression_kind::overmap );
         return true;
     } else {
         return write_to_file( overmap_terrain_filename( p ), writer );
@@ -592,7 +917,8 @@ bool world::write_overmap_player_visibility( const point_abs_om &p, file_write_f
 {
     if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
         sqlite3 *playerdb = get_player_db();
-        write_to_db( playerdb, overmap_player_filename( p ), writer );
+        write_to_db_in_save_order( playerdb, overmap_player_filename( p ), writer,
+                                   compression_kind::overmap );
         return true;
     } else {
         return write_to_player_file( overmap_player_filename( p ), writer );
@@ -610,8 +936,10 @@ static std::string get_mm_filename( const tripoint &p )
 bool world::read_player_mm_quad( const tripoint &p, file_read_json_fn reader )
 {
     if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
+        wait_for_queued_writes();
         sqlite3 *playerdb = get_player_db();
-        return read_from_db_json( playerdb, get_mm_filename( p ), reader, true );
+        return read_from_db_json( playerdb, save_db_statements.read, get_mm_filename( p ), reader,
+                                  true );
     } else {
         return read_from_player_file_json( ".mm1/" + get_mm_filename( p ), reader, true );
     }
@@ -621,7 +949,8 @@ bool world::write_player_mm_quad( const tripoint &p, file_write_fn writer )
 {
     if( info->world_save_format == save_format::V2_COMPRESSED_SQLITE3 ) {
         sqlite3 *playerdb = get_player_db();
-        write_to_db( playerdb, get_mm_filename( p ), writer );
+        write_to_db_in_save_order( playerdb, get_mm_filename( p ), writer,
+                                   compression_kind::map_memory );
         return true;
     } else {
         const std::string descr = string_format(
@@ -646,7 +975,12 @@ sqlite3 *world::get_player_db()
 {
     if( !save_db ) {
         save_db = open_db( info->folder_path() + "/" + get_player_path() + ".sqlite3" );
+        save_db_statements = prepare_statements( save_db );
         last_save_id = g->u.get_save_id();
+        // Opened in the middle of a save, its writes belong to the same transaction
+        if( save_tx_start_ts != 0 ) {
+            exec_in_save_order( save_db, "BEGIN TRANSACTION" );
+        }
     }
 
     if( last_save_id != g->u.get_save_id() ) {
@@ -730,11 +1064,14 @@ void world::convert_from_v1( const std::unique_ptr<WORLDINFO> &old_world )
     // The map database should already be loaded via the constructor.
     // The save database(s) will need to be created separately here.
     // Transactions are mostly being used for performance reasons rather than consistency.
-    sqlite3_exec( map_db, "BEGIN TRANSACTION", NULL, NULL, NULL );
+    exec_statement( map_db, "BEGIN TRANSACTION" );
 
     // Keep track of the last used save DB
     sqlite3 *last_save_db = nullptr;
+    db_statements last_save_db_statements;
     std::string last_save_id;
+    // Not part of any save
+    save_tx_stats stats;
 
     // Begin copying files to the new world folder.
     // This method is BFS, so we'll need to run two passes to keep player-specific
@@ -757,9 +1094,9 @@ void world::convert_from_v1( const std::unique_ptr<WORLDINFO> &old_world )
                     continue;
                 }
                 ::read_from_file( subpath, [&]( std::istream & fin ) {
-                    write_to_db( map_db, map_path, [&]( std::ostream & fout ) {
+                    write_to_db( map_db, map_db_statements.write, map_path, [&]( std::ostream & fout ) {
                         fout << fin.rdbuf();
-                    } );
+                    }, compression_kind::map_quad, stats );
                 } );
             }
             continue;
@@ -768,9 +1105,9 @@ void world::convert_from_v1( const std::unique_ptr<WORLDINFO> &old_world )
         // Migrate o.* files into the map database
         if( part.starts_with( "o." ) ) {
             ::read_from_file( file_path, [&]( std::istream & fin ) {
-                write_to_db( map_db, part, [&]( std::ostream & fout ) {
+                write_to_db( map_db, map_db_statements.write, part, [&]( std::ostream & fout ) {
                     fout << fin.rdbuf();
-                } );
+                }, compression_kind::overmap, stats );
             } );
             continue;
         }
@@ -780,19 +1117,22 @@ void world::convert_from_v1( const std::unique_ptr<WORLDINFO> &old_world )
             auto save_id = part.substr( 0, part.find( '.' ) );
             if( save_id != last_save_id ) {
                 if( last_save_db ) {
-                    sqlite3_exec( last_save_db, "COMMIT", NULL, NULL, NULL );
+                    exec_statement( last_save_db, "COMMIT" );
+                    finalize_statements( last_save_db_statements );
                     sqlite3_close( last_save_db );
                 }
                 last_save_db = open_db( info->folder_path() + "/" + save_id + ".sqlite3" );
+                last_save_db_statements = prepare_statements( last_save_db );
                 last_save_id = save_id;
-                sqlite3_exec( last_save_db, "BEGIN TRANSACTION", NULL, NULL, NULL );
+                exec_statement( last_save_db, "BEGIN TRANSACTION" );
             }
 
             if( part.find( ".seen." ) != std::string::npos ) {
                 ::read_from_file( file_path, [&]( std::istream & fin ) {
-                    write_to_db( last_save_db, part.substr( save_id.size() ), [&]( std::ostream & fout ) {
+                    write_to_db( last_save_db, last_save_db_statements.write, part.substr( save_id.size() ),
+                    [&]( std::ostream & fout ) {
                         fout << fin.rdbuf();
-                    } );
+                    }, compression_kind::overmap, stats );
                 } );
             } else {
                 // Recurse down the directory tree and migrate files into sqlite.
@@ -804,9 +1144,10 @@ void world::convert_from_v1( const std::unique_ptr<WORLDINFO> &old_world )
                         continue;
                     }
                     ::read_from_file( subpath, [&]( std::istream & fin ) {
-                        write_to_db( last_save_db, map_path, [&]( std::ostream & fout ) {
+                        write_to_db( last_save_db, last_save_db_statements.write, map_path,
+                        [&]( std::ostream & fout ) {
                             fout << fin.rdbuf();
-                        } );
+                        }, compression_kind::map_memory, stats );
                     } );
                 }
             }
@@ -821,9 +1162,12 @@ void world::convert_from_v1( const std::unique_ptr<WORLDINFO> &old_world )
     }
 
     if( last_save_db ) {
-        sqlite3_exec( last_save_db, "COMMIT", NULL, NULL, NULL );
+        exec_statement( last_save_db, "COMMIT" );
+        finalize_statements( last_save_db_statements );
         sqlite3_close( last_save_db );
     }
 
-    sqlite3_exec( map_db, "COMMIT", NULL, NULL, NULL );
+    exec_statement( map_db, "COMMIT" );
+    dbg( DL::Info ) << "Converted " << stats.rows_written << " files, " << stats.bytes_uncompressed
+                    << " bytes compressed to " << stats.bytes_compressed;
 }
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <future>
+#include <memory>
+#include <optional>
 #include <string>
 #include "json.h"
 #include "options.h"
@@ -10,6 +15,9 @@
 
 class avatar;
 class sqlite3;
+struct sqlite3_stmt;
+class thread_pool;
+enum class compression_kind : std::uint8_t;
 
 class save_t
 {
@@ -84,6 +92,23 @@ struct WORLDINFO {
         void load_legacy_options( std::istream &fin );
 };
 
+/** Statements for the files table of a save database, prepared once when it's opened. */
+struct db_statements {
+    sqlite3_stmt *exists = nullptr;
+    sqlite3_stmt *read = nullptr;
+    sqlite3_stmt *write = nullptr;
+};
+
+/** Counters for one save transaction. */
+struct save_tx_stats {
+    int64_t rows_written = 0;
+    /** Size of the written data before and after compression. */
+    int64_t bytes_uncompressed = 0;
+    int64_t bytes_compressed = 0;
+    /** From start_save_tx until everything is committed, including time on the writer thread. */
+    int64_t wall_time_ms = 0;
+};
+
 class world
 {
     public:
@@ -99,19 +124,53 @@ class world
          *
          * When using the V1 non-sqlite save system, this merely records some metadata
          * so we can print how long the save took.
+         *
+         * With background saving, writes to the databases during the transaction are only
+         * serialized on the calling thread, compressing and writing them is left to a writer
+         * thread. commit_save_tx then returns how long the calling thread was held up.
          */
         /**@{*/
         void start_save_tx();
         int64_t commit_save_tx();
         /**@}*/
 
+        /**
+         * Blocks until everything queued for the writer thread has reached the databases.
+         * Must be done before quitting, reading from the databases does it automatically.
+         * @returns false if any of the queued writes failed since the last call.
+         */
+        bool wait_for_pending_writes() const;
+
+        /** Counters of the last committed save transaction, once it has reached the databases. */
+        save_tx_stats last_save_stats() const;
+
         /*
          * Targeted/domain-specific file operations. Different save formats may choose to
          * lay out files differently, so centralize file placement logic here rather than
          * scattering it throughout the codebase.
          */
-        bool read_map_quad( const tripoint &om_addr, file_read_json_fn reader ) const;
+        bool read_map_quad( const tripoint &om_addr, file_read_fn reader ) const;
         bool write_map_quad( const tripoint &om_addr, file_write_fn writer ) const;
+        /**
+         * Start reading and decompressing a map quad on a separate thread, for @ref read_map_quad
+         * before it's needed. The result is empty if there is no such quad.
+         * Returns an invalid future if the save format doesn't support it.
+         */
+        std::future<std::optional<std::string>> prefetch_map_quad( const tripoint &om_addr ) const;
+
+        /**
+         * Map quads evicted from memory between saves. They are kept on disk apart from the saved
+         * map, so the save never has map data newer than the rest of it, until the next save takes
+         * them in with @ref save_evicted_map_quads. Whatever a game left there without saving
+         * again is dropped when the world is opened, or by @ref discard_evicted_map_quads.
+         */
+        /**@{*/
+        bool write_evicted_map_quad( const tripoint &om_addr, const std::string &data ) const;
+        /** Reads and removes an evicted quad, empty if there is none. */
+        std::optional<std::string> take_evicted_map_quad( const tripoint &om_addr ) const;
+        void save_evicted_map_quads() const;
+        void discard_evicted_map_quads() const;
+        /**@}*/
 
         bool overmap_exists( const point_abs_om &p ) const;
         bool read_overmap( const point_abs_om &p, file_read_fn reader ) const;
@@ -174,8 +233,38 @@ class world
         std::string get_player_path() const;
 
         sqlite3 *map_db = nullptr;
+        db_statements map_db_statements;
+        /** Only used by @ref map_reader, statements can't be shared between threads. */
+        sqlite3_stmt *prefetch_read = nullptr;
+        /** For the evicted_files table of @ref map_db. */
+        db_statements evicted_statements;
+        sqlite3_stmt *evicted_remove = nullptr;
+        mutable std::unique_ptr<thread_pool> map_reader;
+
+        /** Single worker, so queued writes and transaction statements run in the order they were queued. */
+        std::unique_ptr<thread_pool> save_writer;
+        /** Whether the current save transaction goes through @ref save_writer */
+        bool background_save_tx = false;
+        mutable std::shared_future<void> last_queued_write;
+        mutable std::atomic<bool> queued_write_failed = false;
+
+        /** Counted on whichever thread does the writing, only read after waiting for it. */
+        mutable save_tx_stats current_save_stats;
+        mutable save_tx_stats last_save_stats_;
+
+        void queue_save_job( std::function<void()> job ) const;
+        void wait_for_queued_writes() const;
+        /** Run `job` now, or after everything already queued if in a background save transaction. */
+        void run_in_save_order( std::function<void()> job ) const;
+        /** Execute `sql` on `db`, after everything already queued if in a background save transaction. */
+        void exec_in_save_order( sqlite3 *db, const char *sql ) const;
+        const db_statements &statements_for( sqlite3 *db ) const;
+        /** Write to `db`, on the writer thread if in a background save transaction. */
+        void write_to_db_in_save_order( sqlite3 *db, const std::string &path, file_write_fn writer,
+                                        compression_kind kind ) const;
 
         sqlite3 *save_db = nullptr;
+        db_statements save_db_statements;
         std::string last_save_id = "";
         sqlite3 *get_player_db();
 };
@@ -0,0 +1,32 @@
+#include "catch/catch.hpp"
+
+#include "bitset_grid.h"
+
+TEST_CASE( "bitset_grid_behaves_like_bool_array", "[bitset_grid]" )
+{
+    cata::bitset_grid<5, 7> grid;
+    bool reference[5][7] = {};
+    grid.fill( false );
+    CHECK_FALSE( grid.any() );
+
+    for( int x = 0; x < 5; x++ ) {
+        for( int y = 0; y < 7; y++ ) {
+            const bool value = ( x * 3 + y ) % 4 == 0;
+            grid[x][y] = value;
+            reference[x][y] = value;
+        }
+    }
+
+    const cata::bitset_grid<5, 7> &const_grid = grid;
+    for( int x = 0; x < 5; x++ ) {
+        for( int y = 0; y < 7; y++ ) {
+            CAPTURE( x, y );
+            CHECK( const_grid[x][y] == reference[x][y] );
+            CHECK( grid[x][y] == reference[x][y] );
+        }
+    }
+    CHECK( grid.any() );
+
+    grid.fill( true );
+    CHECK( const_grid[4][6] );
+}
@@ -0,0 +1,192 @@
+#include "catch/catch.hpp"
+
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "binary_io.h"
+#include "compress.h"
+#include "game_constants.h"
+
+// A quad as mapbuffer writes it: four submaps of grass, dirt and trees with a few items about
+static std::string sample_map_quad()
+{
+    std::string quad;
+    cata::binary_writer out( quad );
+    out.write_raw( "BNSM" );
+    out.write_varint( 1 );
+    for( int i = 0; i < 4; i++ ) {
+        out.write_varint( 28 );
+        out.write_signed( 100 + i % 2 );
+        out.write_signed( 200 + i / 2 );
+        out.write_signed( 0 );
+        out.write_signed( 12345 );
+        out.write_signed( 0 );
+        // Terrain
+        out.write_varint( 3 );
+        out.write_string( "t_grass" );
+        out.write_string( "t_dirt" );
+        out.write_string( "t_tree" );
+        out.write_varint( 4 );
+        for( const int run : {
+                 0, 40, 1, 20 + i, 2, 3, 0, 81 - i
+             } ) {
+            out.write_varint( run );
+        }
+        // Furniture and traps
+        for( const char *id : {
+                 "f_null", "tr_null"
+             } ) {
+            out.write_varint( 1 );
+            out.write_string( id );
+            out.write_varint( 1 );
+            out.write_varint( 0 );
+            out.write_varint( 144 );
+        }
+        // Radiation
+        out.write_varint( 1 );
+        out.write_signed( 0 );
+        out.write_varint( 144 );
+        // Fields
+        out.write_varint( 0 );
+        // Items
+        out.write_varint( 2 );
+        out.write_varint( 17 + i );
+        out.write_string( R"([{"typeid":"rock","bday":-3600,"last_rot_check":0,"rot":0}])" );
+        out.write_varint( 90 );
+        out.write_string( R"([{"typeid":"stick","bday":-3600,"owner":"your_followers"}])" );
+        out.write_string( R"({"cosmetics":[],"spawns":[],"vehicles":[],)"
+                          R"("partial_constructions":[],"active_furniture":[]})" );
+    }
+    return quad;
+}
+
+// A region of map memory as map_memory writes it, with a house seen in one submap
+static std::string sample_map_memory()
+{
+    std::string region = R"({"submaps":[)";
+    for( int i = 0; i < MM_REG_SIZE * MM_REG_SIZE; i++ ) {
+        if( i == 21 ) {
+            region += R"([[0,0,0,46,30],[1,0,0,35,12],[2,0,0,46,10],[1,0,0,35],[3,0,0,43],)"
+                      R"([1,0,0,35,10],[2,0,0,46,50],[4,0,0,34,30]],)";
+        } else if( i == 22 ) {
+            region += R"([[0,0,0,46,144]],)";
+        } else {
+            region += "null,";
+        }
+    }
+    region.pop_back();
+    region += R"(],"tile_ids":["t_grass","t_wall","t_floor","t_door_c","t_shrub"]})";
+    return region;
+}
+
+static std::string decompressed( const std::vector<std::byte> &compressed )
+{
+    std::string output;
+    zlib_dict_decompress( compressed.data(), compressed.size(), output );
+    return output;
+}
+
+static std::vector<std::byte> to_bytes( std::initializer_list<unsigned char> values )
+{
+    std::vector<std::byte> result;
+    for( const unsigned char value : values ) {
+        result.push_back( std::byte( value ) );
+    }
+    return result;
+}
+
+TEST_CASE( "zlib_dict_round_trips_every_kind", "[compress]" )
+{
+    const std::string quad = sample_map_quad();
+    const std::string memory = sample_map_memory();
+    for( const compression_kind kind : {
+             compression_kind::generic, compression_kind::map_quad,
+             compression_kind::overmap, compression_kind::map_memory
+         } ) {
+        CAPTURE( static_cast<int>( kind ) );
+        for( const std::string &input : {
+                 std::string(), std::string( "x" ), quad, memory, std::string( 100000, 'a' )
+             } ) {
+            std::vector<std::byte> compressed;
+            zlib_dict_compress( input, kind, compressed );
+            CHECK( decompressed( compressed ) == input );
+        }
+    }
+}
+
+TEST_CASE( "zlib_dict_rejects_damaged_data", "[compress]" )
+{
+    std::vector<std::byte> compressed;
+    zlib_dict_compress( sample_map_quad(), compression_kind::map_quad, compressed );
+    std::string output;
+
+    CHECK_THROWS_AS( zlib_dict_decompress( compressed.data(), 3, output ), std::runtime_error );
+    CHECK_THROWS_AS( zlib_dict_decompress( compressed.data(), compressed.size() - 4, output ),
+                     std::runtime_error );
+    // Claims to be bigger than it is
+    compressed[0] = std::byte( 0xFF );
+    CHECK_THROWS_AS( zlib_dict_decompress( compressed.data(), compressed.size(), output ),
+                     std::runtime_error );
+    // Claims to be bigger than it could possibly be, so is refused before allocating
+    for( size_t i = 0; i < 4; i++ ) {
+        compressed[i] = std::byte( 0xFF );
+    }
+    CHECK_THROWS_AS( zlib_dict_decompress( compressed.data(), compressed.size(), output ),
+                     std::runtime_error );
+}
+
+// Saved data must stay readable, so the dictionaries can never change
+TEST_CASE( "zlib_dict_reads_data_written_with_each_dictionary", "[compress]" )
+{
+    SECTION( "map quads" ) {
+        const std::vector<std::byte> compressed = to_bytes( {
+            0x3b, 0x00, 0x00, 0x00, 0x01, 0x78, 0x3f, 0x52, 0x24, 0x1e, 0x28, 0x43, 0x4e, 0xbd, 0x45, 0xc0,
+            0xc8, 0x85, 0x27, 0x61, 0x5d, 0x63, 0x33, 0x03, 0x03, 0xcc, 0xbc, 0x00, 0x14, 0x02, 0x67, 0x06,
+            0x83, 0xda, 0x58, 0x00, 0x38, 0x9a, 0x12, 0xbf
+        } );
+        CHECK( decompressed( compressed ) ==
+               R"([{"typeid":"rock","bday":-3600,"last_rot_check":0,"rot":0}])" );
+    }
+    SECTION( "map memory" ) {
+        const std::vector<std::byte> compressed = to_bytes( {
+            0x3f, 0x00, 0x00, 0x00, 0x03, 0x78, 0x3f, 0x57, 0x1a, 0x99, 0x8c, 0xc3, 0x70, 0x09, 0x4c, 0x39,
+            0xd0, 0xeb, 0x10, 0xfd, 0x20, 0x43, 0x63, 0x81, 0xe1, 0x88, 0x94, 0x3a, 0x10, 0x61, 0x0a, 0x00,
+            0x88, 0x16, 0x14, 0x91
+        } );
+        CHECK( decompressed( compressed ) ==
+               R"({"submaps":[null,[[0,0,0,46,144]],null],"tile_ids":["t_grass"]})" );
+    }
+}
+
+TEST_CASE( "legacy_zlib_still_round_trips", "[compress]" )
+{
+    const std::string quad = sample_map_quad();
+    std::vector<std::byte> compressed;
+    zlib_compress( quad, compressed );
+    std::string output;
+    zlib_decompress( compressed.data(), compressed.size(), output );
+    CHECK( output == quad );
+}
+
+TEST_CASE( "map_quad_dictionary_beats_plain_zlib", "[compress]" )
+{
+    const std::string quad = sample_map_quad();
+    std::vector<std::byte> plain;
+    zlib_compress( quad, plain );
+    std::vector<std::byte> with_dictionary;
+    zlib_dict_compress( quad, compression_kind::map_quad, with_dictionary );
+    CHECK( with_dictionary.size() < plain.size() );
+}
+
+TEST_CASE( "map_memory_dictionary_beats_plain_zlib", "[compress]" )
+{
+    const std::string memory = sample_map_memory();
+    std::vector<std::byte> plain;
+    zlib_compress( memory, plain );
+    std::vector<std::byte> with_dictionary;
+    zlib_dict_compress( memory, compression_kind::map_memory, with_dictionary );
+    CHECK( with_dictionary.size() < plain.size() );
+}
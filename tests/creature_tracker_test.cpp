@@ -0,0 +1,107 @@
+#include "catch/catch.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "creature_tracker.h"
+#include "game.h"
+#include "line.h"
+#include "map_helpers.h"
+#include "mapdata.h"
+#include "memory_fast.h"
+#include "monster.h"
+#include "point.h"
+#include "state_helpers.h"
+
+static std::vector<monster *> sorted( const std::vector<shared_ptr_fast<monster>> &found )
+{
+    std::vector<monster *> result;
+    for( const shared_ptr_fast<monster> &ptr : found ) {
+        result.push_back( ptr.get() );
+    }
+    std::ranges::sort( result );
+    return result;
+}
+
+static std::vector<monster *> brute_force_in_radius( const tripoint &center, int radius )
+{
+    std::vector<monster *> result;
+    for( monster &critter : g->all_monsters() ) {
+        if( rl_dist( center, critter.pos() ) <= radius ) {
+            result.push_back( &critter );
+        }
+    }
+    std::ranges::sort( result );
+    return result;
+}
+
+static void check_queries_match_brute_force()
+{
+    const Creature_tracker &tracker = *g->critter_tracker;
+    for( const tripoint &center : {
+             tripoint( 60, 60, 0 ), tripoint( 5, 5, 0 ), tripoint( 100, 30, 0 )
+         } ) {
+        for( const int radius : {
+                 0, 3, 12, 30, 200
+             } ) {
+            INFO( center.to_string() << " radius " << radius );
+            CHECK( sorted( tracker.find_in_radius( center, radius ) ) ==
+                   brute_force_in_radius( center, radius ) );
+        }
+    }
+}
+
+TEST_CASE( "creature_tracker_spatial_queries", "[creature_tracker]" )
+{
+    clear_all_state();
+    build_test_map( t_floor );
+
+    std::vector<monster *> monsters;
+    for( int i = 0; i < 60; i++ ) {
+        monsters.push_back( &spawn_test_monster( "mon_zombie", tripoint( 10 + ( i % 10 ) * 11,
+                                                 10 + ( i / 10 ) * 17, 0 ) ) );
+    }
+    check_queries_match_brute_force();
+
+    GIVEN( "monsters moving across submaps" ) {
+        for( int i = 0; i < 60; i += 3 ) {
+            monsters[i]->setpos( monsters[i]->pos() + tripoint( 5, 7, 0 ) );
+        }
+        check_queries_match_brute_force();
+    }
+
+    GIVEN( "monsters swapping places" ) {
+        REQUIRE( g->swap_critters( *monsters[0], *monsters[59] ) );
+        check_queries_match_brute_force();
+    }
+
+    GIVEN( "monsters removed and dying" ) {
+        g->remove_zombie( *monsters[5] );
+        monsters[6]->die( nullptr );
+        monsters[7]->die( nullptr );
+        check_queries_match_brute_force();
+        g->cleanup_dead();
+        check_queries_match_brute_force();
+    }
+
+    THEN( "rectangle queries are inclusive" ) {
+        const tripoint corner = monsters[11]->pos();
+        const std::vector<shared_ptr_fast<monster>> found =
+            g->critter_tracker->find_in_rectangle( corner, corner + tripoint( 11, 0, 0 ) );
+        REQUIRE( found.size() == 2 );
+    }
+
+    THEN( "faction queries only return that faction" ) {
+        monsters[0]->friendly = -1;
+        g->critter_tracker->update_faction( *monsters[0] );
+        const tripoint center = monsters[0]->pos();
+        const std::vector<shared_ptr_fast<monster>> friends =
+            g->critter_tracker->find_in_radius( center, 5, mfaction_str_id( "player" ).id() );
+        REQUIRE( friends.size() == 1 );
+        CHECK( friends[0].get() == monsters[0] );
+        const std::vector<monster *> zombies =
+            sorted( g->critter_tracker->find_in_radius( center, 20, monsters[1]->faction ) );
+        CHECK( std::ranges::find( zombies, monsters[0] ) == zombies.end() );
+        CHECK( std::ranges::find( zombies, monsters[1] ) != zombies.end() );
+    }
+}
@@ -0,0 +1,56 @@
+#include "catch/catch.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "debug.h"
+
+TEST_CASE( "collected_debugmsgs_are_held_back_until_replayed", "[debug]" )
+{
+    std::vector<deferred_debugmsg> messages;
+    const std::string during = capture_debugmsg_during( [&]() {
+        messages = collect_debugmsgs_during( []() {
+            debugmsg( "first" );
+            debugmsg( "second" );
+        } );
+    } );
+    CHECK( during.empty() );
+    REQUIRE( messages.size() == 2 );
+    CHECK( messages[0].text == "first" );
+    CHECK( messages[1].text == "second" );
+
+    const std::string replayed = capture_debugmsg_during( [&]() {
+        replay_debugmsgs( messages );
+    } );
+    CHECK( replayed == "firstsecond" );
+}
+
+TEST_CASE( "nested_debugmsg_collection_restores_outer_collector", "[debug]" )
+{
+    std::vector<deferred_debugmsg> inner;
+    const std::vector<deferred_debugmsg> outer = collect_debugmsgs_during( [&]() {
+        debugmsg( "outer before" );
+        inner = collect_debugmsgs_during( []() {
+            debugmsg( "inner" );
+        } );
+        debugmsg( "outer after" );
+    } );
+    REQUIRE( inner.size() == 1 );
+    CHECK( inner[0].text == "inner" );
+    REQUIRE( outer.size() == 2 );
+    CHECK( outer[0].text == "outer before" );
+    CHECK( outer[1].text == "outer after" );
+}
+
+TEST_CASE( "debugmsg_collection_ends_when_the_function_throws", "[debug]" )
+{
+    CHECK_THROWS_AS( collect_debugmsgs_during( []() {
+        throw std::runtime_error( "checker failed" );
+    } ), std::runtime_error );
+
+    const std::string dmsg = capture_debugmsg_during( []() {
+        debugmsg( "reported" );
+    } );
+    CHECK( dmsg == "reported" );
+}
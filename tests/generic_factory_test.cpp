@@ -108,6 +108,33 @@ TEST_CASE( "generic_factory_repeated_invalidation", "[generic_factory]" )
     }
 }
 
+TEST_CASE( "generic_factory_finalized_lookup_of_uncached_ids", "[generic_factory]" )
+{
+    generic_factory<test_obj> test_factory( "test_factory" );
+    for( int i = 0; i < 500; ++i ) {
+        test_factory.insert( { test_obj_id( "id_" + std::to_string( i ) ), "value_" + std::to_string( i ) } );
+    }
+    test_factory.finalize();
+
+    // Fresh ids have no cached index, so they go through the lookup table
+    for( int i = 0; i < 500; ++i ) {
+        const test_obj_id id( "id_" + std::to_string( i ) );
+        CAPTURE( id.str() );
+        REQUIRE( test_factory.is_valid( id ) );
+        CHECK( test_factory.obj( test_obj_id( id.str() ) ).value == "value_" + std::to_string( i ) );
+        CHECK( test_factory.convert( test_obj_id( id.str() ), int_id<test_obj>( -1 ) ).to_i() == i );
+    }
+    CHECK_FALSE( test_factory.is_valid( test_obj_id( "id_500" ) ) );
+    CHECK_FALSE( test_factory.is_valid( test_obj_id( "non_existent_id" ) ) );
+
+    THEN( "ids inserted after finalization are found too" ) {
+        test_factory.insert( { test_obj_id( "id_500" ), "value_500" } );
+        CHECK( test_factory.is_valid( test_obj_id( "id_500" ) ) );
+        CHECK( test_factory.is_valid( test_obj_id( "id_42" ) ) );
+        CHECK( test_factory.obj( test_obj_id( "id_500" ) ).value == "value_500" );
+    }
+}
+
 TEST_CASE( "generic_factory_common_null_ids", "[generic_factory]" )
 {
     CHECK( itype_id::NULL_ID().is_null() );
@@ -207,6 +234,28 @@ TEST_CASE( "generic_factory_lookup_benchmark", "[.][generic_factory][benchmark]"
     BENCHMARK( "single lookup" ) {
         return test_factory.obj( id_200 ).value;
     };
+
+    // Copies of an id that was never looked up, so the cached index can't be used
+    const test_obj_id uncached_200( "id_200" );
+    const test_obj_id uncached_missing( "id_1000" );
+    BENCHMARK( "single uncached lookup" ) {
+        const test_obj_id id = uncached_200;
+        return test_factory.obj( id ).value;
+    };
+    BENCHMARK( "single uncached lookup, missing id" ) {
+        const test_obj_id id = uncached_missing;
+        return test_factory.is_valid( id );
+    };
+
+    test_factory.finalize();
+    BENCHMARK( "single uncached lookup, finalized" ) {
+        const test_obj_id id = uncached_200;
+        return test_factory.obj( id ).value;
+    };
+    BENCHMARK( "single uncached lookup, missing id, finalized" ) {
+        const test_obj_id id = uncached_missing;
+        return test_factory.is_valid( id );
+    };
 }
 
 TEST_CASE( "string_id_compare_benchmark", "[.][generic_factory][string_id][benchmark]" )
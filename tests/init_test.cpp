@@ -0,0 +1,120 @@
+#include "catch/catch.hpp"
+
+#include <map>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "debug.h"
+#include "emit.h"
+#include "filesystem.h"
+#include "fstream_utils.h"
+#include "init.h"
+#include "json.h"
+#include "loading_ui.h"
+#include "options_helpers.h"
+#include "path_info.h"
+#include "requirements.h"
+#include "type_id.h"
+#include "veh_type.h"
+
+namespace
+{
+
+struct checked_data_snapshot {
+    std::map<vpart_id, std::tuple<requirement_data::alter_item_comp_vector, int, itype_id>> vparts;
+    std::map<emit_id, std::tuple<int, int, int>> emits;
+
+    bool operator==( const checked_data_snapshot & ) const = default;
+};
+
+checked_data_snapshot snapshot_checked_data()
+{
+    checked_data_snapshot result;
+    for( const auto &[id, part] : vpart_info::all() ) {
+        result.vparts.emplace( id, std::make_tuple( part.install_requirements().get_components(),
+                               part.removal_moves,
+                               part.fuel_type ) );
+    }
+    for( const auto &[id, e] : emit::all() ) {
+        result.emits.emplace( id, std::make_tuple( e.intensity(), e.qty(), e.chance() ) );
+    }
+    return result;
+}
+
+} // namespace
+
+TEST_CASE( "skipping_verified_checks_leaves_data_unchanged", "[init]" )
+{
+    override_option skip_checks( "SKIP_VERIFIED_DATA_CHECKS", "true" );
+    remove_file( PATH_INFO::verified_data() );
+    loading_ui ui( false );
+    const checked_data_snapshot before = snapshot_checked_data();
+
+    // Nothing verified yet, so this runs every checker and records the data as verified
+    DynamicDataLoader::get_instance().check_consistency( ui, true );
+    REQUIRE( file_exist( PATH_INFO::verified_data() ) );
+    CHECK( snapshot_checked_data() == before );
+
+    // Same data again, so the checkers are skipped
+    DynamicDataLoader::get_instance().check_consistency( ui, true );
+    CHECK( snapshot_checked_data() == before );
+
+    remove_file( PATH_INFO::verified_data() );
+}
+
+TEST_CASE( "loading_data_files_stops_cleanly_at_a_bad_file", "[init]" )
+{
+    const std::string dir = PATH_INFO::config_dir() + "load_data_files_test/";
+    REQUIRE( assure_dir_exist( dir ) );
+    const auto write = [&]( const std::string & name, const std::string & contents ) {
+        const std::string path = dir + name;
+        REQUIRE( write_to_file( path, [&]( std::ostream & fout ) {
+            fout << contents;
+        }, nullptr ) );
+        return path;
+    };
+    // Objects after the failure are never looked at, so their members must not be reported
+    const std::string good = R"([{"type":"test"}])";
+    const std::string unread = R"([{"type":"test","unread":1}])";
+    std::vector<std::string> files = {
+        write( "good.json", good ),
+        write( "bad.json", R"([{"type":"test",)" ),
+    };
+    for( int i = 0; i < 8; ++i ) {
+        files.push_back( write( "unread_" + std::to_string( i ) + ".json", unread ) );
+    }
+
+    std::vector<std::string> loaded;
+    const auto load = [&]( const std::string & path, uint64_t, std::vector<JsonObject> &objects ) {
+        loaded.push_back( path );
+        for( const JsonObject &jo : objects ) {
+            jo.get_string( "type" );
+        }
+    };
+
+    SECTION( "a file that isn't valid JSON" ) {
+        const std::string dmsg = capture_debugmsg_during( [&]() {
+            CHECK_THROWS_AS( init::load_data_files( files, load ), JsonError );
+        } );
+        CHECK( dmsg.empty() );
+        CHECK( loaded == std::vector<std::string> { files[0] } );
+    }
+
+    SECTION( "a file that fails to load" ) {
+        files.erase( files.begin(), files.begin() + 2 );
+        const std::string dmsg = capture_debugmsg_during( [&]() {
+            CHECK_THROWS_AS( init::load_data_files( files, [&]( const std::string & path, uint64_t,
+            std::vector<JsonObject> & ) {
+                loaded.push_back( path );
+                throw std::runtime_error( "load failed" );
+            } ), std::runtime_error );
+        } );
+        CHECK( dmsg.empty() );
+        CHECK( loaded == std::vector<std::string> { files[0] } );
+    }
+
+    remove_tree( dir );
+}
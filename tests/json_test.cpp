@@ -2,11 +2,15 @@
 
 #include <list>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "bodypart.h"
 #include "json.h"
 #include "cached_options.h"
 #include "cata_utility.h"
+#include "filesystem.h"
 #include "string_formatter.h"
 #include "type_id.h"
 
@@ -252,6 +256,8 @@ static void test_get_string( const std::string &str, const std::string &json )
     std::istringstream iss( json );
     JsonIn jsin( iss );
     CHECK( jsin.get_string() == str );
+    JsonIn jsin_buffer{ std::string_view( json ) };
+    CHECK( jsin_buffer.get_string() == str );
 }
 
 template<typename Matcher>
@@ -261,6 +267,8 @@ static void test_get_string_throws_matches( Matcher &&matcher, const std::string
     std::istringstream iss( json );
     JsonIn jsin( iss );
     CHECK_THROWS_MATCHES( jsin.get_string(), JsonError, matcher );
+    JsonIn jsin_buffer{ std::string_view( json ) };
+    CHECK_THROWS_MATCHES( jsin_buffer.get_string(), JsonError, matcher );
 }
 
 template<typename Matcher>
@@ -272,6 +280,8 @@ static void test_string_error_throws_matches( Matcher &&matcher, const std::stri
     std::istringstream iss( json );
     JsonIn jsin( iss );
     CHECK_THROWS_MATCHES( jsin.string_error( "<message>", offset ), JsonError, matcher );
+    JsonIn jsin_buffer{ std::string_view( json ) };
+    CHECK_THROWS_MATCHES( jsin_buffer.string_error( "<message>", offset ), JsonError, matcher );
 }
 
 TEST_CASE( "jsonin_get_string", "[json]" )
@@ -481,3 +491,87 @@ TEST_CASE( "serialize_optional", "[json]" )
         test_serialization( v, "[1,2,3]" );
     }
 }
+
+static void skip_all_values( JsonIn &jsin )
+{
+    while( jsin.good() ) {
+        jsin.eat_whitespace();
+        if( jsin.peek() == EOF ) {
+            break;
+        }
+        jsin.skip_value();
+    }
+}
+
+TEST_CASE( "jsonin_buffer_matches_stream", "[json]" )
+{
+    const std::string json =
+        R"({ "id": "foo", "list": [ 1, -2.5e3, true, false, null ], "name": { "str": "b\u00e4r" } })";
+    std::istringstream iss( json );
+    JsonIn from_stream( iss );
+    JsonIn from_buffer{ std::string_view( json ) };
+    for( JsonIn *jsin : {
+             &from_stream, &from_buffer
+         } ) {
+        JsonObject jo = jsin->get_object();
+        CHECK( jo.get_string( "id" ) == "foo" );
+        JsonArray ja = jo.get_array( "list" );
+        CHECK( ja.next_int() == 1 );
+        CHECK( ja.next_float() == -2500.0 );
+        CHECK( ja.next_bool() );
+        CHECK( !ja.next_bool() );
+        CHECK( ja.test_null() );
+        CHECK( jo.get_object( "name" ).get_string( "str" ) == "b\u00e4r" );
+    }
+
+    THEN( "seeking to a source location reads the same value" ) {
+        const std::string array = R"([ "a", { "b": 2 } ])";
+        JsonIn jsin( std::string_view( array ), json_source_location{ nullptr, 7 } );
+        CHECK( jsin.get_object().get_int( "b" ) == 2 );
+    }
+}
+
+// Parses everything in data/json once, like game startup does before loading the objects.
+TEST_CASE( "jsonin_data_json_benchmark", "[.][json][benchmark]" )
+{
+    std::vector<std::string> contents;
+    for( const std::string &file : get_files_from_path( ".json", "data/json", true, true ) ) {
+        contents.push_back( read_entire_file( file ) );
+    }
+    REQUIRE( !contents.empty() );
+
+    BENCHMARK( "istringstream" ) {
+        size_t files = 0;
+        for( const std::string &data : contents ) {
+            std::istringstream iss( data );
+            JsonIn jsin( iss );
+            skip_all_values( jsin );
+            files++;
+        }
+        return files;
+    };
+
+    BENCHMARK( "buffer" ) {
+        size_t files = 0;
+        for( const std::string &data : contents ) {
+            JsonIn jsin{ std::string_view( data ) };
+            skip_all_values( jsin );
+            files++;
+        }
+        return files;
+    };
+
+    BENCHMARK( "buffer, indexing objects" ) {
+        size_t members = 0;
+        for( const std::string &data : contents ) {
+            JsonIn jsin{ std::string_view( data ) };
+            if( jsin.test_array() ) {
+                for( JsonObject jo : jsin.get_array() ) {
+                    jo.allow_omitted_members();
+                    members += jo.size();
+                }
+            }
+        }
+        return members;
+    };
+}
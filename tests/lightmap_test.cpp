@@ -0,0 +1,72 @@
+#include "catch/catch.hpp"
+
+#include <vector>
+
+#include "calendar.h"
+#include "game.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "point.h"
+#include "shadowcasting.h"
+#include "state_helpers.h"
+#include "type_id.h"
+
+static std::vector<four_quadrants> lightmap_snapshot( const map &here, int z )
+{
+    const level_cache &cache = here.access_cache( z );
+    return std::vector<four_quadrants>( &cache.lm[0][0], &cache.lm[0][0] + MAPSIZE_X * MAPSIZE_Y );
+}
+
+static void check_same_as_full_rebuild( map &here, int z )
+{
+    here.build_map_cache( z );
+    const std::vector<four_quadrants> incremental = lightmap_snapshot( here, z );
+
+    here.access_cache( z ).buffered_light.reset();
+    here.build_map_cache( z );
+    const std::vector<four_quadrants> full = lightmap_snapshot( here, z );
+
+    for( size_t i = 0; i < full.size(); i++ ) {
+        INFO( "at " << point( i / MAPSIZE_Y, i % MAPSIZE_Y ).to_string() );
+        REQUIRE( incremental[i].values == full[i].values );
+    }
+}
+
+TEST_CASE( "incremental_lightmap_matches_full_rebuild", "[lightmap]" )
+{
+    clear_all_state();
+    build_test_map( ter_id( "t_floor" ) );
+    calendar::turn = calendar::turn_zero;
+    g->reset_light_level();
+
+    map &here = get_map();
+    const ter_id t_utility_light( "t_utility_light" );
+    const ter_id t_brick_wall( "t_brick_wall" );
+    const int z = 0;
+
+    here.ter_set( tripoint( 50, 50, z ), t_utility_light );
+    here.ter_set( tripoint( 53, 50, z ), t_utility_light );
+    here.ter_set( tripoint( 90, 90, z ), t_utility_light );
+    here.build_map_cache( z );
+
+    SECTION( "nothing changed" ) {
+        check_same_as_full_rebuild( here, z );
+    }
+
+    SECTION( "wall built next to a light" ) {
+        for( int y = 45; y <= 55; y++ ) {
+            here.ter_set( tripoint( 52, y, z ), t_brick_wall );
+        }
+        check_same_as_full_rebuild( here, z );
+    }
+
+    SECTION( "light removed" ) {
+        here.ter_set( tripoint( 53, 50, z ), ter_id( "t_floor" ) );
+        check_same_as_full_rebuild( here, z );
+    }
+
+    SECTION( "light added far from the others" ) {
+        here.ter_set( tripoint( 20, 100, z ), t_utility_light );
+        check_same_as_full_rebuild( here, z );
+    }
+}
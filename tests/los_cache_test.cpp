@@ -0,0 +1,173 @@
+#include "catch/catch.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "game_constants.h"
+#include "los_cache.h"
+#include "lru_cache.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "mapdata.h"
+#include "monster.h"
+#include "point.h"
+#include "state_helpers.h"
+
+TEST_CASE( "los_cache_stores_pairs_in_either_order", "[los_cache]" )
+{
+    los_cache cache;
+    const tripoint a( 10, 20, 0 );
+    const tripoint b( 30, 5, 0 );
+    const tripoint c( 30, 5, 1 );
+
+    CHECK( !cache.get( a, b ).has_value() );
+
+    cache.insert( a, b, true );
+    cache.insert( a, c, false );
+    CHECK( cache.get( a, b ) == std::optional<bool>( true ) );
+    CHECK( cache.get( b, a ) == std::optional<bool>( true ) );
+    CHECK( cache.get( c, a ) == std::optional<bool>( false ) );
+    CHECK( !cache.get( b, c ).has_value() );
+
+    cache.insert( b, a, false );
+    CHECK( cache.get( a, b ) == std::optional<bool>( false ) );
+}
+
+TEST_CASE( "los_cache_invalidate_forgets_everything", "[los_cache]" )
+{
+    los_cache cache;
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        cache.insert( tripoint( x, 0, 0 ), tripoint( 0, x, 0 ), true );
+    }
+    cache.invalidate();
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        CHECK( !cache.get( tripoint( x, 0, 0 ), tripoint( 0, x, 0 ) ).has_value() );
+    }
+
+    cache.insert( tripoint( 1, 2, 0 ), tripoint( 3, 4, 0 ), true );
+    CHECK( cache.get( tripoint( 1, 2, 0 ), tripoint( 3, 4, 0 ) ) == std::optional<bool>( true ) );
+}
+
+TEST_CASE( "los_cache_never_returns_wrong_pair_when_full", "[los_cache]" )
+{
+    // Many more pairs than there are slots, so plenty of them get overwritten
+    los_cache cache;
+    const auto visible = []( int x, int y ) {
+        return ( x * 7 + y * 3 ) % 5 == 0;
+    };
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            for( int z = 0; z < 10; z++ ) {
+                cache.insert( tripoint( x, y, z ), tripoint( y, x, -z - 1 ), visible( x, y + z ) );
+            }
+        }
+    }
+    size_t found = 0;
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            for( int z = 0; z < 10; z++ ) {
+                const std::optional<bool> cached = cache.get( tripoint( x, y, z ), tripoint( y, x, -z - 1 ) );
+                if( cached ) {
+                    found++;
+                    CHECK( *cached == visible( x, y + z ) );
+                }
+            }
+        }
+    }
+    CHECK( found > 0 );
+    CHECK( found <= los_cache::capacity );
+}
+
+TEST_CASE( "map_sees_cache_follows_transparency_changes", "[los_cache][map]" )
+{
+    clear_all_state();
+    build_test_map( t_floor );
+    map &here = get_map();
+
+    const tripoint from( 60, 60, 0 );
+    const tripoint to( 70, 60, 0 );
+    REQUIRE( here.sees( from, to, 60 ) );
+    REQUIRE( here.sees( to, from, 60 ) );
+
+    here.ter_set( tripoint( 65, 60, 0 ), t_rock_wall );
+    here.build_map_cache( 0 );
+    CHECK( !here.sees( from, to, 60 ) );
+    CHECK( !here.sees( to, from, 60 ) );
+}
+
+// Every monster checks every other monster, like a turn of a large fight.
+TEST_CASE( "los_cache_mass_monster_benchmark", "[.][los_cache][benchmark]" )
+{
+    clear_all_state();
+    build_test_map( t_floor );
+    map &here = get_map();
+
+    std::vector<tripoint> positions;
+    for( int i = 0; i < 200; i++ ) {
+        const tripoint p( 20 + ( i % 20 ) * 5, 10 + ( i / 20 ) * 10, 0 );
+        spawn_test_monster( "mon_zombie", p );
+        positions.push_back( p );
+    }
+    here.build_map_cache( 0 );
+
+    const auto old_key = []( const tripoint & a, const tripoint & b ) {
+        const tripoint &min = a < b ? a : b;
+        const tripoint &max = !( a < b ) ? a : b;
+        return point( min.x << 16 | min.y << 8 | ( min.z + OVERMAP_DEPTH ),
+                      max.x << 16 | max.y << 8 | ( max.z + OVERMAP_DEPTH ) );
+    };
+
+    lru_cache<point, char> lru;
+    los_cache flat;
+    for( const tripoint &a : positions ) {
+        for( const tripoint &b : positions ) {
+            lru.insert( 100000, old_key( a, b ), 1 );
+            flat.insert( a, b, true );
+        }
+    }
+
+    BENCHMARK( "lru_cache hits" ) {
+        int total = 0;
+        for( const tripoint &a : positions ) {
+            for( const tripoint &b : positions ) {
+                total += lru.get( old_key( a, b ), -1 );
+            }
+        }
+        return total;
+    };
+
+    BENCHMARK( "los_cache hits" ) {
+        int total = 0;
+        for( const tripoint &a : positions ) {
+            for( const tripoint &b : positions ) {
+                total += flat.get( a, b ).value_or( false );
+            }
+        }
+        return total;
+    };
+
+    BENCHMARK( "map::sees, warm cache" ) {
+        int total = 0;
+        for( const tripoint &a : positions ) {
+            for( const tripoint &b : positions ) {
+                total += here.sees( a, b, 60 );
+            }
+        }
+        return total;
+    };
+
+    BENCHMARK( "map::sees, after invalidation" ) {
+        here.set_transparency_cache_dirty( 0 );
+        here.ter_set( tripoint( 1, 1, 0 ), here.ter( tripoint( 1, 1, 0 ) ) == t_floor ?
+                      t_rock_wall : t_floor );
+        here.build_map_cache( 0 );
+        int total = 0;
+        for( const tripoint &a : positions ) {
+            for( const tripoint &b : positions ) {
+                total += here.sees( a, b, 60 );
+            }
+        }
+        return total;
+    };
+}
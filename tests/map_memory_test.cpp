@@ -75,6 +75,59 @@ TEST_CASE( "map_memory_forgets", "[map_memory]" )
     memory.memorize_symbol( p3, 1 );
 }
 
+TEST_CASE( "map_memory_region_round_trip", "[map_memory]" )
+{
+    mm_region region;
+    for( auto &column : region.submaps ) {
+        for( shared_ptr_fast<mm_submap> &sm : column ) {
+            sm = make_shared_fast<mm_submap>();
+        }
+    }
+    const memorized_terrain_tile floor{ memorized_tile_id( "t_floor" ), 1, 2 };
+    const memorized_terrain_tile wall{ memorized_tile_id( "t_wall" ), 0, 3 };
+    region.submaps[0][0]->set_tile( point_zero, floor );
+    region.submaps[0][0]->set_tile( point_east, wall );
+    region.submaps[1][0]->set_tile( point_south, floor );
+    region.submaps[1][0]->set_symbol( point_south, 'x' );
+
+    std::ostringstream os;
+    JsonOut jsout( os );
+    region.serialize( jsout );
+    const std::string saved = os.str();
+    // Every tile id is written only once
+    CHECK( saved.find( "t_floor" ) == saved.rfind( "t_floor" ) );
+
+    std::istringstream is( saved );
+    JsonIn jsin( is );
+    mm_region loaded;
+    loaded.deserialize( jsin );
+    CHECK( loaded.submaps[0][0]->tile( point_zero ) == floor );
+    CHECK( loaded.submaps[0][0]->tile( point_east ) == wall );
+    CHECK( loaded.submaps[0][0]->tile( point_south ) == mm_submap::default_tile );
+    CHECK( loaded.submaps[1][0]->tile( point_south ) == floor );
+    CHECK( loaded.submaps[1][0]->symbol( point_south ) == 'x' );
+    CHECK( loaded.submaps[0][1]->is_empty() );
+}
+
+TEST_CASE( "map_memory_region_loads_legacy_format", "[map_memory]" )
+{
+    // Tile ids as strings, and no table
+    std::string legacy = R"([[["t_floor",1,2,0,2],["",0,0,0,142]])";
+    for( int i = 1; i < MM_REG_SIZE * MM_REG_SIZE; i++ ) {
+        legacy += ",null";
+    }
+    legacy += "]";
+
+    std::istringstream is( legacy );
+    JsonIn jsin( is );
+    mm_region loaded;
+    loaded.deserialize( jsin );
+    const memorized_terrain_tile floor{ memorized_tile_id( "t_floor" ), 1, 2 };
+    CHECK( loaded.submaps[0][0]->tile( point_east ) == floor );
+    CHECK( loaded.submaps[0][0]->tile( point_south ) == mm_submap::default_tile );
+    CHECK( loaded.submaps[1][0]->is_empty() );
+}
+
 // TODO: map memory save / load
 
 #include <chrono>
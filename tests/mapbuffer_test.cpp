@@ -0,0 +1,96 @@
+#include "catch/catch.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "coordinate_conversions.h"
+#include "cuboid_rectangle.h"
+#include "mapbuffer.h"
+#include "mapdata.h"
+#include "point.h"
+#include "state_helpers.h"
+#include "submap.h"
+
+// Far away from the test map, one quad apart along x
+static tripoint quad_origin( int i )
+{
+    return tripoint( 10000 + i * 2, 10000, 0 );
+}
+
+static constexpr size_t submap_bytes = sizeof( submap ) + submap::tile_storage_bytes();
+
+static void add_quad( mapbuffer &mb, int i )
+{
+    const tripoint origin = quad_origin( i );
+    for( const point &offset : {
+             point_zero, point_south, point_east, point_south_east
+         } ) {
+        const tripoint p = origin + offset;
+        std::unique_ptr<submap> sm = std::make_unique<submap>( sm_to_ms_copy( p ) );
+        sm->set_all_ter( t_floor );
+        // Not uniform, so it has to be kept instead of regenerated
+        sm->set_ter( point( i % SEEX, 0 ), t_rock_wall );
+        REQUIRE( mb.add_submap( p, sm ) );
+    }
+}
+
+TEST_CASE( "mapbuffer_evicts_least_recently_used_quads", "[mapbuffer]" )
+{
+    clear_all_state();
+    mapbuffer mb;
+    for( int i = 0; i < 8; i++ ) {
+        add_quad( mb, i );
+    }
+    REQUIRE( mb.get_stats().resident == 32 );
+
+    // Quad 0 is kept by area, quad 1 by being used last
+    const inclusive_cuboid<tripoint> keep( quad_origin( 0 ), quad_origin( 0 ) + point_south_east );
+    REQUIRE( mb.lookup_submap( quad_origin( 1 ) ) != nullptr );
+    mb.evict_cold_submaps( 12 * submap_bytes, keep );
+
+    const mapbuffer_stats evicted = mb.get_stats();
+    CHECK( evicted.resident == 12 );
+    CHECK( evicted.evicted == 20 );
+    CHECK( evicted.reloaded == 0 );
+    CHECK( mb.is_submap_loaded( quad_origin( 0 ) ) );
+    CHECK( mb.is_submap_loaded( quad_origin( 1 ) ) );
+    // The oldest ones went first
+    CHECK( !mb.is_submap_loaded( quad_origin( 2 ) ) );
+    CHECK( mb.is_submap_loaded( quad_origin( 7 ) ) );
+
+    THEN( "evicted submaps come back unchanged" ) {
+        const tripoint p = quad_origin( 3 ) + point_east;
+        submap *sm = mb.lookup_submap( p );
+        REQUIRE( sm != nullptr );
+        CHECK( sm->get_ter( point( 3, 0 ) ) == t_rock_wall );
+        CHECK( sm->get_ter( point( 4, 0 ) ) == t_floor );
+        CHECK( mb.get_stats().reloaded == 4 );
+        CHECK( mb.get_stats().resident == 16 );
+    }
+
+    THEN( "nothing is evicted while under budget" ) {
+        mb.evict_cold_submaps( 100 * submap_bytes, keep );
+        CHECK( mb.get_stats().evicted == 20 );
+    }
+}
+
+TEST_CASE( "mapbuffer_budget_ignores_shared_uniform_submaps", "[mapbuffer]" )
+{
+    clear_all_state();
+    mapbuffer mb;
+    add_quad( mb, 0 );
+    for( int i = 1; i < 8; i++ ) {
+        for( const point &offset : {
+                 point_zero, point_south, point_east, point_south_east
+             } ) {
+            const tripoint p = quad_origin( i ) + offset;
+            std::unique_ptr<submap> sm = std::make_unique<submap>( sm_to_ms_copy( p ), t_rock );
+            REQUIRE( mb.add_submap( p, sm ) );
+        }
+    }
+    const inclusive_cuboid<tripoint> keep( quad_origin( 8 ), quad_origin( 8 ) );
+    mb.evict_cold_submaps( 4 * submap_bytes, keep );
+    CHECK( mb.get_stats().evicted == 0 );
+    CHECK( mb.get_stats().resident == 32 );
+}
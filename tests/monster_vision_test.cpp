@@ -1,6 +1,9 @@
 #include "catch/catch.hpp"
 
+#include <algorithm>
+#include <cstdlib>
 #include <memory>
+#include <vector>
 
 #include "calendar.h"
 #include "game.h"
@@ -101,3 +104,109 @@ TEST_CASE( "monsters_dont_see_through_vehicle_holes", "[vision]" )
     CHECK( !outside.sees( inside ) );
 
 }
+
+TEST_CASE( "batched_sight_matches_single_queries", "[vision]" )
+{
+    clear_all_state();
+    build_test_map( t_floor );
+    map &here = get_map();
+    // Wall from ( 70, 40 ) to ( 70, 80 ), with a gap at ( 70, 60 )
+    for( int y = 40; y <= 80; y++ ) {
+        if( y != 60 ) {
+            here.ter_set( tripoint( 70, y, 0 ), t_rock_wall );
+        }
+    }
+    here.build_map_cache( 0 );
+
+    const std::vector<tripoint> observers = { tripoint( 60, 60, 0 ), tripoint( 80, 45, 0 ) };
+
+    GIVEN( "few targets" ) {
+        const std::vector<tripoint> targets = {
+            tripoint( 60, 61, 0 ), tripoint( 85, 60, 0 ), tripoint( 80, 50, 0 ),
+            tripoint( 60, 45, 0 ), tripoint( 60, 60, 0 )
+        };
+        const std::vector<bool> batched = here.sees( observers, targets, 60 );
+        here.set_transparency_cache_dirty( 0 );
+        here.build_map_cache( 0 );
+        for( size_t o = 0; o < observers.size(); o++ ) {
+            for( size_t t = 0; t < targets.size(); t++ ) {
+                INFO( observers[o].to_string() << " -> " << targets[t].to_string() );
+                CHECK( batched[o * targets.size() + t] == here.sees( observers[o], targets[t], 60 ) );
+            }
+        }
+    }
+
+    GIVEN( "enough targets to shadowcast" ) {
+        std::vector<tripoint> targets;
+        for( int x = 50; x <= 90; x += 2 ) {
+            for( int y = 50; y <= 70; y += 2 ) {
+                targets.emplace_back( x, y, 0 );
+            }
+        }
+        const std::vector<bool> batched = here.sees( observers, targets, 60 );
+        for( size_t t = 0; t < targets.size(); t++ ) {
+            const tripoint &to = targets[t];
+            INFO( to.to_string() );
+            // Same side of the wall is always visible
+            if( to.x < 70 ) {
+                CHECK( batched[t] );
+            } else if( to.x > 70 ) {
+                CHECK( batched[targets.size() + t] );
+            }
+            // Far behind the wall and away from the gap is never visible
+            if( to.x >= 80 && std::abs( to.y - 60 ) >= 6 ) {
+                CHECK( !batched[t] );
+            }
+        }
+
+        // Shadowcast results don't leak into single queries through the cache
+        std::vector<bool> after_batch;
+        for( const tripoint &from : observers ) {
+            for( const tripoint &to : targets ) {
+                after_batch.push_back( here.sees( from, to, 60 ) );
+            }
+        }
+        here.set_transparency_cache_dirty( 0 );
+        here.build_map_cache( 0 );
+        size_t i = 0;
+        for( const tripoint &from : observers ) {
+            for( const tripoint &to : targets ) {
+                INFO( from.to_string() << " -> " << to.to_string() );
+                CHECK( after_batch[i++] == here.sees( from, to, 60 ) );
+            }
+        }
+    }
+}
+
+TEST_CASE( "batched_sight_benchmark", "[.][vision][benchmark]" )
+{
+    clear_all_state();
+    build_test_map( t_floor );
+    map &here = get_map();
+
+    std::vector<tripoint> positions;
+    for( int i = 0; i < 400; i++ ) {
+        positions.emplace_back( 20 + ( i % 20 ) * 5, 10 + ( i / 20 ) * 5, 0 );
+    }
+    const std::vector<tripoint> observers( positions.begin(), positions.begin() + 200 );
+    const std::vector<tripoint> targets( positions.begin() + 200, positions.end() );
+
+    BENCHMARK( "one line per pair" ) {
+        here.set_transparency_cache_dirty( 0 );
+        here.build_map_cache( 0 );
+        int total = 0;
+        for( const tripoint &from : observers ) {
+            for( const tripoint &to : targets ) {
+                total += here.sees( from, to, 60 );
+            }
+        }
+        return total;
+    };
+
+    BENCHMARK( "batched" ) {
+        here.set_transparency_cache_dirty( 0 );
+        here.build_map_cache( 0 );
+        const std::vector<bool> seen = here.sees( observers, targets, 60 );
+        return std::count( seen.begin(), seen.end(), true );
+    };
+}
@@ -213,3 +213,39 @@ TEST_CASE( "mutable_overmap_placement", "[overmap][slow]" )
         CHECK( successes > num_trials_per_overmap / 2 );
     }
 }
+
+TEST_CASE( "overmap_generation_waves_keep_neighbors_apart", "[overmap]" )
+{
+    std::vector<point_abs_om> locs;
+    for( int x = -2; x <= 2; x++ ) {
+        for( int y = -1; y <= 3; y++ ) {
+            locs.emplace_back( x, y );
+        }
+    }
+    // Duplicates are generated only once
+    locs.emplace_back( 0, 0 );
+
+    const std::vector<std::vector<point_abs_om>> waves = overmapbuffer::generation_waves( locs );
+    // One wave per diagonal of a 5x5 square
+    CHECK( waves.size() == 9 );
+
+    std::vector<point_abs_om> seen;
+    for( const std::vector<point_abs_om> &wave : waves ) {
+        for( const point_abs_om &loc : wave ) {
+            CAPTURE( loc );
+            CHECK( std::find( seen.begin(), seen.end(), loc ) == seen.end() );
+            for( const point &offset : four_adjacent_offsets ) {
+                CHECK( std::find( wave.begin(), wave.end(), loc + offset ) == wave.end() );
+            }
+            // West and north neighbors were generated earlier
+            if( loc.x() > -2 ) {
+                CHECK( std::find( seen.begin(), seen.end(), loc + point_west ) != seen.end() );
+            }
+            if( loc.y() > -1 ) {
+                CHECK( std::find( seen.begin(), seen.end(), loc + point_north ) != seen.end() );
+            }
+        }
+        seen.insert( seen.end(), wave.begin(), wave.end() );
+    }
+    CHECK( seen.size() == 25 );
+}
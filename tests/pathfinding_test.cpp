@@ -0,0 +1,207 @@
+#include "catch/catch.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include "map.h"
+#include "map_helpers.h"
+#include "mapdata.h"
+#include "monster.h"
+#include "options_helpers.h"
+#include "pathfinding.h"
+#include "point.h"
+#include "rng.h"
+#include "state_helpers.h"
+
+TEST_CASE( "pathfinding_d_maps_persist_between_turns", "[pathfinding]" )
+{
+    clear_all_state();
+    build_test_map( t_floor );
+    Pathfinding::clear_d_maps();
+    Pathfinding::reset_cache_stats();
+
+    const tripoint from( 60, 60, 0 );
+    const tripoint to( 70, 60, 0 );
+
+    const std::vector<tripoint> first = Pathfinding::route( from, to );
+    REQUIRE( !first.empty() );
+    CHECK( Pathfinding::get_cache_stats().misses == 1 );
+
+    Pathfinding::retire_d_maps();
+
+    const std::vector<tripoint> second = Pathfinding::route( from, to );
+    CHECK( second == first );
+    CHECK( Pathfinding::get_cache_stats().hits == 1 );
+    CHECK( Pathfinding::get_cache_stats().misses == 1 );
+
+    GIVEN( "a change to a tile the d_map never reached" ) {
+        get_map().ter_set( tripoint( 10, 10, 0 ), t_rock_wall );
+        THEN( "the d_map is kept" ) {
+            CHECK( Pathfinding::get_cache_stats().invalidations == 0 );
+            Pathfinding::route( from, to );
+            CHECK( Pathfinding::get_cache_stats().hits == 2 );
+        }
+    }
+
+    GIVEN( "a wall built across the path" ) {
+        for( int y = 50; y <= 70; y++ ) {
+            get_map().ter_set( tripoint( 65, y, 0 ), t_rock_wall );
+        }
+        THEN( "the d_map is invalidated and the new route avoids the wall" ) {
+            CHECK( Pathfinding::get_cache_stats().invalidations == 1 );
+            const std::vector<tripoint> rerouted = Pathfinding::route( from, to );
+            CHECK( Pathfinding::get_cache_stats().misses == 2 );
+            REQUIRE( !rerouted.empty() );
+            for( const tripoint &p : rerouted ) {
+                CHECK( get_map().ter( p ) != t_rock_wall );
+            }
+        }
+    }
+
+    Pathfinding::clear_d_maps();
+}
+
+static void check_route_is_walkable( const std::vector<tripoint> &route, const tripoint &from,
+                                     const tripoint &to )
+{
+    REQUIRE( !route.empty() );
+    CHECK( route.front() == from );
+    CHECK( route.back() == to );
+    for( size_t i = 0; i < route.size(); i++ ) {
+        INFO( "step " << i << " at " << route[i].to_string() );
+        CHECK( get_map().passable( route[i] ) );
+        if( i > 0 ) {
+            CHECK( square_dist( route[i - 1], route[i] ) <= 1 );
+        }
+    }
+}
+
+TEST_CASE( "hierarchical_pathfinding_crosses_the_map", "[pathfinding]" )
+{
+    clear_all_state();
+    build_test_map( t_floor );
+    Pathfinding::clear_d_maps();
+
+    override_option opt( "PATHFINDING_HIERARCHICAL", "true" );
+
+    const tripoint from( 6, 60, 0 );
+    const tripoint to( 125, 60, 0 );
+
+    GIVEN( "open terrain" ) {
+        const std::vector<tripoint> route = Pathfinding::route( from, to );
+        check_route_is_walkable( route, from, to );
+        THEN( "the route is close to a straight line" ) {
+            CHECK( route.size() <= static_cast<size_t>( square_dist( from, to ) * 1.1 ) );
+        }
+    }
+
+    GIVEN( "a wall with a single gap far from the straight line" ) {
+        const tripoint gap( 66, 110, 0 );
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            if( y != gap.y ) {
+                get_map().ter_set( tripoint( gap.x, y, 0 ), t_rock_wall );
+            }
+        }
+        const std::vector<tripoint> route = Pathfinding::route( from, to );
+        check_route_is_walkable( route, from, to );
+        THEN( "the route goes through the gap" ) {
+            CHECK( std::find( route.begin(), route.end(), gap ) != route.end() );
+        }
+    }
+
+    GIVEN( "a wall without any gaps" ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            get_map().ter_set( tripoint( 66, y, 0 ), t_rock_wall );
+        }
+        THEN( "there is no route" ) {
+            CHECK( Pathfinding::route( from, to ).empty() );
+        }
+    }
+
+    Pathfinding::clear_d_maps();
+}
+
+TEST_CASE( "flow_field_steps_lead_to_target", "[pathfinding]" )
+{
+    clear_all_state();
+    build_test_map( t_floor );
+    Pathfinding::clear_d_maps();
+    Pathfinding::reset_cache_stats();
+
+    for( int y = 40; y <= 80; y++ ) {
+        get_map().ter_set( tripoint( 65, y, 0 ), t_rock_wall );
+    }
+
+    const tripoint to( 75, 60, 0 );
+    const std::vector<tripoint> starts = {
+        tripoint( 55, 60, 0 ), tripoint( 55, 45, 0 ), tripoint( 50, 75, 0 )
+    };
+
+    for( const tripoint &from : starts ) {
+        INFO( "from " << from.to_string() );
+        tripoint cur = from;
+        int steps = 0;
+        while( cur != to && steps < 100 ) {
+            const std::optional<tripoint> step = Pathfinding::next_step( cur, to );
+            REQUIRE( step.has_value() );
+            CHECK( square_dist( cur, *step ) == 1 );
+            CHECK( get_map().passable( *step ) );
+            cur = *step;
+            steps++;
+        }
+        CHECK( cur == to );
+    }
+
+    THEN( "every follower shares a single field" ) {
+        CHECK( Pathfinding::get_cache_stats().misses == 1 );
+    }
+
+    Pathfinding::clear_d_maps();
+}
+
+TEST_CASE( "flow_field_horde_benchmark", "[.][pathfinding][benchmark]" )
+{
+    clear_all_state();
+    build_test_map( t_floor );
+    Pathfinding::clear_d_maps();
+
+    const tripoint target( 66, 66, 0 );
+    std::vector<monster *> horde;
+    for( int i = 0; i < 200; i++ ) {
+        const tripoint start( 20 + ( i % 20 ) * 5, 10 + ( i / 20 ) * 3, 0 );
+        horde.push_back( &spawn_test_monster( "mon_zombie", start ) );
+    }
+
+    // The target moves a little every turn, as the player would
+    const auto moved_target = [&]() {
+        return target + point( rng( -1, 1 ), rng( -1, 1 ) );
+    };
+
+    BENCHMARK( "per-monster routes, d_maps dropped every turn" ) {
+        // What every turn used to cost: d_maps were cleared between turns, so the first
+        // monster built the d_map and every monster then traced its own route
+        Pathfinding::clear_d_maps();
+        const tripoint moved = moved_target();
+        size_t total = 0;
+        for( const monster *z : horde ) {
+            const auto pair = z->get_pathfinding_pair();
+            total += Pathfinding::route( z->pos(), moved, pair.first, pair.second ).size();
+        }
+        return total;
+    };
+
+    BENCHMARK( "shared flow field, d_maps dropped every turn" ) {
+        // Same worst case, the target moved somewhere nobody has a field for yet
+        Pathfinding::clear_d_maps();
+        const tripoint moved = moved_target();
+        size_t total = 0;
+        for( const monster *z : horde ) {
+            const auto pair = z->get_pathfinding_pair();
+            total += Pathfinding::next_step( z->pos(), moved, pair.first, pair.second ).has_value();
+        }
+        return total;
+    };
+
+    Pathfinding::clear_d_maps();
+}
@@ -2,9 +2,11 @@
 
 #include <functional>
 #include <optional>
+#include <thread>
 #include <vector>
 
 #include "test_statistics.h"
+#include "point.h"
 #include "rng.h"
 
 static void check_remainder( float proportion )
@@ -78,3 +80,56 @@ TEST_CASE( "random_entry_preserves_constness" )
     i1 = 5678;
     CHECK( v1[0] == 5678 );
 }
+
+TEST_CASE( "scoped_rng_seed_is_independent_of_earlier_use" )
+{
+    const auto sample = []() {
+        std::vector<double> result;
+        for( int i = 0; i < 10; i++ ) {
+            result.push_back( rng( 0, 1000 ) );
+            result.push_back( normal_roll( 0, 10 ) );
+        }
+        return result;
+    };
+
+    std::vector<double> first;
+    {
+        const scoped_rng_seed seed( 1234 );
+        first = sample();
+    }
+    rng_set_engine_seed( 42 );
+    const int reference = rng( 0, 1000000 );
+
+    rng_set_engine_seed( 42 );
+    // Leaves a cached value in the normal distribution
+    normal_roll( 5, 1 );
+    rng_set_engine_seed( 42 );
+    {
+        const scoped_rng_seed seed( 1234 );
+        CHECK( sample() == first );
+    }
+    // Continues where it was before the scope
+    CHECK( rng( 0, 1000000 ) == reference );
+}
+
+TEST_CASE( "location_seeds_differ_between_domains" )
+{
+    const tripoint p( 3, -7, 0 );
+    CHECK( rng_location_seed( 1234, rng_seed_domain::mapgen, p ) ==
+           rng_location_seed( 1234, rng_seed_domain::mapgen, p ) );
+    CHECK( rng_location_seed( 1234, rng_seed_domain::mapgen, p ) !=
+           rng_location_seed( 1234, rng_seed_domain::overmap, p ) );
+    CHECK( rng_location_seed( 1234, rng_seed_domain::mapgen, p ) !=
+           rng_location_seed( 1234, rng_seed_domain::mapgen, p + tripoint_above ) );
+}
+
+TEST_CASE( "new_threads_start_from_the_engine_seed" )
+{
+    rng_set_engine_seed( 4321 );
+    const int here = rng( 0, 1000000 );
+    int there = -1;
+    std::thread( [&]() {
+        there = rng( 0, 1000000 );
+    } ).join();
+    CHECK( there == here );
+}
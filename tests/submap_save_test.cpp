@@ -0,0 +1,177 @@
+#include "catch/catch.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "binary_io.h"
+#include "calendar.h"
+#include "field.h"
+#include "field_type.h"
+#include "game.h"
+#include "item.h"
+#include "json.h"
+#include "mapdata.h"
+#include "point.h"
+#include "state_helpers.h"
+#include "submap.h"
+#include "trap.h"
+#include "type_id.h"
+
+static const itype_id itype_rock( "rock" );
+static const itype_id itype_2x4( "2x4" );
+static const mtype_id mon_zombie( "mon_zombie" );
+
+// Somewhat cluttered, like a submap in a town after some looting and fighting
+static void fill_submap( submap &sm )
+{
+    sm.set_all_ter( t_floor );
+    sm.last_touched = calendar::turn_zero + 12345_turns;
+    sm.set_temperature( -7 );
+    for( int i = 0; i < SEEX; i++ ) {
+        sm.set_ter( point( i, 0 ), t_rock_wall );
+        sm.set_furn( point( i, 5 ), i % 3 ? f_chair : f_table );
+        sm.set_radiation( point( i, 9 ), i / 4 );
+        sm.get_items( point( i, 7 ) ).push_back( item::spawn( i % 2 ? itype_rock : itype_2x4 ) );
+    }
+    sm.set_trap( point( 3, 3 ), trap_str_id( "tr_bubblewrap" ).id() );
+    sm.get_field( point( 4, 4 ) ).add_field( fd_blood, 2, 10_turns );
+    sm.get_field( point( 4, 4 ) ).add_field( fd_fire, 1, 3_turns );
+    sm.field_count++;
+    sm.spawns.emplace_back( mon_zombie, 2, point( 6, 6 ) );
+}
+
+static void check_same_submap( const submap &a, const submap &b )
+{
+    CHECK( a.last_touched == b.last_touched );
+    CHECK( a.get_temperature() == b.get_temperature() );
+    CHECK( a.field_count == b.field_count );
+    for( int i = 0; i < SEEX; i++ ) {
+        for( int j = 0; j < SEEY; j++ ) {
+            const point p( i, j );
+            CAPTURE( p );
+            CHECK( a.get_ter( p ) == b.get_ter( p ) );
+            CHECK( a.get_furn( p ) == b.get_furn( p ) );
+            CHECK( a.get_trap( p ) == b.get_trap( p ) );
+            CHECK( a.get_radiation( p ) == b.get_radiation( p ) );
+            CHECK( a.get_field( p ).field_count() == b.get_field( p ).field_count() );
+            for( auto &elem : a.get_field( p ) ) {
+                const field_entry *other = b.get_field( p ).find_field( elem.first );
+                REQUIRE( other != nullptr );
+                CHECK( other->get_field_intensity() == elem.second.get_field_intensity() );
+                CHECK( other->get_field_age() == elem.second.get_field_age() );
+            }
+            CHECK( std::equal( a.get_items( p ).begin(), a.get_items( p ).end(),
+                               b.get_items( p ).begin(), b.get_items( p ).end(),
+            []( const item * x, const item * y ) {
+                return x->typeId() == y->typeId();
+            } ) );
+        }
+    }
+    REQUIRE( a.spawns.size() == b.spawns.size() );
+    for( size_t k = 0; k < a.spawns.size(); k++ ) {
+        CHECK( a.spawns[k].type == b.spawns[k].type );
+        CHECK( a.spawns[k].count == b.spawns[k].count );
+        CHECK( a.spawns[k].pos == b.spawns[k].pos );
+    }
+}
+
+static std::string store_json( const submap &sm )
+{
+    std::ostringstream os;
+    JsonOut jsout( os );
+    jsout.start_object();
+    sm.store( jsout );
+    jsout.end_object();
+    return os.str();
+}
+
+static void load_json( submap &sm, const std::string &data )
+{
+    std::istringstream is( data );
+    JsonIn jsin( is );
+    jsin.start_object();
+    while( !jsin.end_object() ) {
+        const std::string member_name = jsin.get_member_name();
+        sm.load( jsin, member_name, savegame_version, tripoint_zero );
+    }
+}
+
+TEST_CASE( "submap_binary_round_trip", "[submap][save]" )
+{
+    clear_all_state();
+    submap original( tripoint_zero );
+    fill_submap( original );
+
+    std::string data;
+    cata::binary_writer out( data );
+    original.store_binary( out );
+
+    submap loaded( tripoint_zero );
+    cata::binary_reader in( data );
+    loaded.load_binary( in, savegame_version, tripoint_zero );
+    CHECK( in.at_end() );
+    check_same_submap( original, loaded );
+
+    THEN( "it is smaller than the JSON" ) {
+        CHECK( data.size() < store_json( original ).size() );
+    }
+
+    THEN( "truncated data is rejected" ) {
+        submap broken( tripoint_zero );
+        cata::binary_reader truncated( std::string_view( data ).substr( 0, data.size() / 2 ) );
+        CHECK_THROWS( broken.load_binary( truncated, savegame_version, tripoint_zero ) );
+    }
+}
+
+TEST_CASE( "binary_io_round_trips_varints", "[submap][save]" )
+{
+    std::string data;
+    cata::binary_writer out( data );
+    out.write_varint( 0 );
+    out.write_varint( 127 );
+    out.write_varint( 128 );
+    out.write_varint( UINT64_MAX );
+    out.write_signed( -1 );
+    out.write_signed( INT64_MIN );
+    out.write_string( "t_floor" );
+    CHECK( data.size() == 1 + 1 + 2 + 10 + 1 + 10 + 8 );
+
+    cata::binary_reader in( data );
+    CHECK( in.read_varint() == 0 );
+    CHECK( in.read_varint() == 127 );
+    CHECK( in.read_varint() == 128 );
+    CHECK( in.read_varint() == UINT64_MAX );
+    CHECK( in.read_signed() == -1 );
+    CHECK( in.read_signed() == INT64_MIN );
+    CHECK( in.read_string() == "t_floor" );
+    CHECK( in.at_end() );
+    CHECK_THROWS( in.read_varint() );
+}
+
+TEST_CASE( "submap_load_benchmark", "[.][submap][save][benchmark]" )
+{
+    clear_all_state();
+    submap original( tripoint_zero );
+    fill_submap( original );
+
+    const std::string json = store_json( original );
+    std::string binary;
+    cata::binary_writer out( binary );
+    original.store_binary( out );
+
+    BENCHMARK( "JSON" ) {
+        submap sm( tripoint_zero );
+        load_json( sm, json );
+        return sm.field_count;
+    };
+
+    BENCHMARK( "binary" ) {
+        submap sm( tripoint_zero );
+        cata::binary_reader in( binary );
+        sm.load_binary( in, savegame_version, tripoint_zero );
+        return sm.field_count;
+    };
+}
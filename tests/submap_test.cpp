@@ -90,3 +90,31 @@ TEST_CASE( "submap rotation", "[submap]" )
         }
     }
 }
+
+TEST_CASE( "uniform submaps share tiles until written to", "[submap]" )
+{
+    submap a( tripoint_zero, ter_id( 5 ) );
+    submap b( tripoint( SEEX, 0, 0 ), ter_id( 5 ) );
+    REQUIRE( a.is_uniform );
+    REQUIRE( a.shares_tiles() );
+    REQUIRE( b.shares_tiles() );
+
+    const submap &const_a = a;
+    CHECK( const_a.get_items( point_zero ).empty() );
+    CHECK( const_a.get_field( point_zero ).field_count() == 0 );
+    a.rotate( 1 );
+    CHECK( a.shares_tiles() );
+
+    WHEN( "one of them is changed" ) {
+        a.set_ter( point_south_east, ter_id( 7 ) );
+
+        THEN( "only that one gets its own copy" ) {
+            CHECK( !a.is_uniform );
+            CHECK( !a.shares_tiles() );
+            CHECK( b.shares_tiles() );
+            CHECK( a.get_ter( point_south_east ) == ter_id( 7 ) );
+            CHECK( a.get_ter( point_zero ) == ter_id( 5 ) );
+            CHECK( b.get_ter( point_south_east ) == ter_id( 5 ) );
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#include "catch/catch.hpp"
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#include "thread_pool.h"
+
+TEST_CASE( "thread_pool_runs_submitted_jobs", "[thread_pool]" )
+{
+    thread_pool pool( 3 );
+    std::vector<std::future<int>> results;
+    for( int i = 0; i < 10; i++ ) {
+        results.push_back( pool.submit( [i]() {
+            return i * i;
+        } ) );
+    }
+    for( int i = 0; i < 10; i++ ) {
+        CHECK( results[i].get() == i * i );
+    }
+}
+
+TEST_CASE( "thread_pool_parallel_for", "[thread_pool]" )
+{
+    const int num_workers = GENERATE( 0, 1, 4 );
+    const bool parallel = GENERATE( true, false );
+    CAPTURE( num_workers, parallel );
+    thread_pool pool( num_workers );
+
+    SECTION( "every index is visited once" ) {
+        std::vector<std::atomic<int>> visits( 100 );
+        pool.parallel_for( 0, 100, [&]( int i ) {
+            visits[i]++;
+        }, parallel );
+        for( const std::atomic<int> &v : visits ) {
+            CHECK( v.load() == 1 );
+        }
+    }
+
+    SECTION( "nested calls don't deadlock" ) {
+        std::atomic<int> total = 0;
+        pool.parallel_for( 0, 8, [&]( int ) {
+            pool.parallel_for( 0, 8, [&]( int ) {
+                total++;
+            }, parallel );
+        }, parallel );
+        CHECK( total.load() == 64 );
+    }
+
+    SECTION( "exceptions are rethrown on the calling thread" ) {
+        std::atomic<int> calls = 0;
+        CHECK_THROWS_AS( pool.parallel_for( 0, 20, [&]( int i ) {
+            calls++;
+            if( i == 7 ) {
+                throw std::runtime_error( "test" );
+            }
+        }, parallel ), std::runtime_error );
+        if( parallel && num_workers > 0 ) {
+            // Everything else still gets done
+            CHECK( calls.load() == 20 );
+        }
+    }
+}
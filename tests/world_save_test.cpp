@@ -0,0 +1,107 @@
+#include "catch/catch.hpp"
+
+#include <future>
+#include <istream>
+#include <iterator>
+#include <optional>
+#include <ostream>
+#include <string>
+
+#include "coordinates.h"
+#include "game.h"
+#include "options_helpers.h"
+#include "point.h"
+#include "world.h"
+
+static std::string read_back( world &w, const point_abs_om &p )
+{
+    std::string result;
+    w.read_overmap( p, [&]( std::istream & fin ) {
+        result.assign( std::istreambuf_iterator<char>( fin ), std::istreambuf_iterator<char>() );
+    } );
+    return result;
+}
+
+static void check_save_round_trip( const std::string &background )
+{
+    override_option opt( "BACKGROUND_SAVE", background );
+    world &w = *g->get_active_world();
+    // Far away from anything the other tests generate
+    const point_abs_om p( 12345, -12345 );
+
+    w.start_save_tx();
+    for( int i = 0; i < 10; i++ ) {
+        w.write_overmap( p, [&]( std::ostream & fout ) {
+            fout << "save " << i << " with background " << background;
+        } );
+    }
+    w.commit_save_tx();
+
+    const save_tx_stats stats = w.last_save_stats();
+    CHECK( stats.rows_written == 10 );
+    CHECK( stats.bytes_uncompressed > 0 );
+    CHECK( stats.bytes_compressed > 0 );
+    CHECK( stats.wall_time_ms >= 0 );
+
+    CHECK( w.overmap_exists( p ) );
+    CHECK( read_back( w, p ) == "save 9 with background " + background );
+    CHECK( w.wait_for_pending_writes() );
+}
+
+TEST_CASE( "world_save_reads_see_queued_writes", "[world][save]" )
+{
+    SECTION( "background save" ) {
+        check_save_round_trip( "true" );
+    }
+    SECTION( "foreground save" ) {
+        check_save_round_trip( "false" );
+    }
+}
+
+TEST_CASE( "world_prefetch_sees_queued_writes", "[world][save]" )
+{
+    override_option opt( "BACKGROUND_SAVE", "true" );
+    world &w = *g->get_active_world();
+    // Far away from anything the other tests generate
+    const tripoint om_addr( 12345, -12345, 0 );
+
+    w.start_save_tx();
+    w.write_map_quad( om_addr, [&]( std::ostream & fout ) {
+        fout << "quad data";
+    } );
+    w.commit_save_tx();
+
+    std::future<std::optional<std::string>> present = w.prefetch_map_quad( om_addr );
+    std::future<std::optional<std::string>> missing = w.prefetch_map_quad( om_addr + tripoint_east );
+    REQUIRE( present.valid() );
+    REQUIRE( missing.valid() );
+    CHECK( present.get() == std::optional<std::string>( "quad data" ) );
+    CHECK( !missing.get().has_value() );
+    CHECK( w.wait_for_pending_writes() );
+}
+
+TEST_CASE( "world_evicted_map_quads_join_the_next_save", "[world][save]" )
+{
+    world &w = *g->get_active_world();
+    // Far away from anything the other tests generate
+    const tripoint taken( 12345, -12345, 1 );
+    const tripoint saved( 12345, -12345, 2 );
+
+    REQUIRE( w.write_evicted_map_quad( taken, "taken quad" ) );
+    REQUIRE( w.write_evicted_map_quad( saved, "saved quad" ) );
+    CHECK( w.take_evicted_map_quad( taken ) == std::optional<std::string>( "taken quad" ) );
+    CHECK( !w.take_evicted_map_quad( taken ).has_value() );
+    CHECK( !w.read_map_quad( saved, []( std::istream & ) {} ) );
+
+    w.start_save_tx();
+    w.save_evicted_map_quads();
+    w.commit_save_tx();
+    CHECK( w.wait_for_pending_writes() );
+
+    std::string result;
+    CHECK( w.read_map_quad( saved, [&]( std::istream & fin ) {
+        result.assign( std::istreambuf_iterator<char>( fin ), std::istreambuf_iterator<char>() );
+    } ) );
+    CHECK( result == "saved quad" );
+    CHECK( !w.take_evicted_map_quad( saved ).has_value() );
+}